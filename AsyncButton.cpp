@@ -5,186 +5,3149 @@ MIT License */
 
 #define ABUTTON_LOG_PREFIX ANSI_GRAY "[AsyncButton] " ANSI_DEFAULT
 
+#if defined(BUTTON_EVENT_QUEUE) || defined(BUTTON_HANDLERS)
+#define ABUTTON_EVENTS // Edges are turned into events
+#endif
+
+#if defined(BUTTON_INTERRUPT) && defined(__AVR__) && defined(digitalPinToPCICR) && !defined(BUTTON_PCINT_DISABLE)
+#if defined(PCINT3_vect)
+#define ABUTTON_PCINT 4 // Pin change interrupt banks handled by the library
+#elif defined(PCINT2_vect)
+#define ABUTTON_PCINT 3 // Pin change interrupt banks handled by the library
+#elif defined(PCINT1_vect)
+#define ABUTTON_PCINT 2 // Pin change interrupt banks handled by the library
+#elif defined(PCINT0_vect)
+#define ABUTTON_PCINT 1 // Pin change interrupt banks handled by the library
+#endif
+#endif
+
+#if !defined(BUTTON_SLEEP) && defined(ABUTTON_PCINT)
+#include <avr/sleep.h>
+#elif !defined(BUTTON_SLEEP) && defined(ARDUINO_ARCH_ESP32)
+#include <esp_sleep.h>
+#include <driver/gpio.h>
+#endif
+
+#ifdef BUTTON_SNAPSHOT
+#include <stddef.h>
+#endif
+
+#if defined(BUTTON_TIMER) && defined(BUTTON_TIMER2)
+#if !defined(__AVR__) || !defined(TCCR2A)
+#error "AsyncButton: BUTTON_TIMER2 needs an AVR with Timer2, call tick() from your own timer instead"
+#else
+#define ABUTTON_TIMER2 // Timer2 compare match drives tick()
+#endif
+#endif
+
+#if defined(BUTTON_ENCODERS) && !defined(DRAM_ATTR)
+#define DRAM_ATTR
+#endif
+
 namespace AsyncButton
 {
+#ifndef BUTTON_NO_DEFAULT_CONFIG
     static AsyncButton::State Buttons[] = {
-        {BUTTON_OK, RELEASED, false, 0, 0, RELEASED, 0, 0, 255, nullptr},
-        {BUTTON_CONFIRM, RELEASED, false, 0, 0, RELEASED, 0, 0, BUTTON_OK, nullptr},
-        {BUTTON_CANCEL, RELEASED, false, 0, 0, RELEASED, 0, 0, 255, nullptr},
+        BUTTON_STATE(BUTTON_OK, 255),
+        BUTTON_STATE(BUTTON_CONFIRM, BUTTON_OK),
+        BUTTON_STATE(BUTTON_CANCEL, 255),
+    };
+    AsyncButton::Config ButtonConfig = BUTTON_CONFIG(Buttons, sizeof(Buttons) / sizeof(AsyncButton::State));
+
+    AsyncButton::Config *Current = &ButtonConfig;
+#else
+    AsyncButton::Config *Current = nullptr; // Set by the first setup()
+#endif
+    static const AsyncButton::Timing DefaultTiming = {BUTTON_DEBOUNCE_TIME, BUTTON_DOUBLECLICK_TIME, BUTTON_LONGPRESS_TIME, 0};
+
+    static inline const AsyncButton::Timing &timingOf(const AsyncButton::Config &conf)
+    {
+        return conf.timing ? *conf.timing : DefaultTiming;
+    }
+
+    static inline const AsyncButton::Timing &timingOf(const AsyncButton::State &button, const AsyncButton::Timing &shared)
+    {
+#ifdef BUTTON_TIMING_PROFILES
+        return button.timing ? *button.timing : shared;
+#else
+        (void)button;
+        return shared;
+#endif
+    }
+
+    static inline AsyncButton::Time elapsed(AsyncButton::Time now, AsyncButton::Time since)
+    {
+        return (AsyncButton::Time)(now - since);
+    }
+
+    // Bring the next deadline of this update forward to wait from now
+    static inline void due(AsyncButton::Config &conf, AsyncButton::Time wait)
+    {
+        if (wait < conf.deadline)
+            conf.deadline = wait;
+    }
+
+#ifdef BUTTON_TIMER
+    static AsyncButton::Config *volatile ticking = nullptr; // Config sampled by tick()
+    static volatile AsyncButton::Time ticks = 0;            // Milliseconds counted by tick()
+
+#if defined(ARDUINO_ARCH_ESP32)
+    static portMUX_TYPE tickLock = portMUX_INITIALIZER_UNLOCKED; // tick() may run on the other core
+#endif
+
+    // Keep tick() out, returns the interrupt state to hand back to unlock()
+    static inline uint8_t lock()
+    {
+#if defined(__AVR__)
+        uint8_t sreg = SREG;
+        cli();
+        return sreg;
+#elif defined(ARDUINO_ARCH_ESP32)
+        portENTER_CRITICAL(&tickLock);
+        return 0;
+#else
+        noInterrupts();
+        __asm__ __volatile__("" ::: "memory");
+        return 0;
+#endif
+    }
+
+    // Restore the interrupt state saved by lock(), a caller that had interrupts off keeps them off
+    static inline void unlock(uint8_t saved)
+    {
+#if defined(__AVR__)
+        SREG = saved;
+#elif defined(ARDUINO_ARCH_ESP32)
+        (void)saved;
+        portEXIT_CRITICAL(&tickLock);
+#else
+        (void)saved;
+        __asm__ __volatile__("" ::: "memory");
+        interrupts();
+#endif
+    }
+#endif
+
+    // Clock read once per update(), counted by tick() for the timer-sampled configuration
+    static inline AsyncButton::Time timeOf(const AsyncButton::Config &conf)
+    {
+#ifdef BUTTON_TIMER
+        if (&conf == ticking)
+        {
+            uint8_t saved = lock();
+            Time now = ticks;
+            unlock(saved);
+#ifdef BUTTON_SNAPSHOT
+            now += conf.epoch;
+#endif
+            return now;
+        }
+#endif
+#ifdef BUTTON_SNAPSHOT
+        return (Time)BUTTON_TIME() + conf.epoch;
+#else
+        (void)conf;
+        return (Time)BUTTON_TIME();
+#endif
+    }
+
+#ifdef BUTTON_RTOS
+    // Holds the guard of a Config while its scan task runs, so a query from another task never sees half a scan
+    class Guard
+    {
+    public:
+        explicit Guard(const AsyncButton::Config &conf) : mutex(conf.task ? conf.guard : nullptr)
+        {
+            if (mutex)
+                xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+        }
+
+        ~Guard()
+        {
+            if (mutex)
+                xSemaphoreGiveRecursive(mutex);
+        }
+
+    private:
+        SemaphoreHandle_t mutex;
+    };
+#define ABUTTON_GUARD Guard guard(conf)
+
+    // The live state of a Config with a running scan task belongs to that task
+    static inline bool offTask(const AsyncButton::Config &conf)
+    {
+        return conf.task && xTaskGetCurrentTaskHandle() != conf.task;
+    }
+#else
+#define ABUTTON_GUARD
+#endif
+
+#ifdef BUTTON_PROFILE
+    // Times the enclosing scope into a Span, raising BUTTON_PROFILE_PIN meanwhile when marked
+    class Probe
+    {
+    public:
+        explicit Probe(AsyncButton::Span &span, bool mark = false) : span(span)
+        {
+#ifdef BUTTON_PROFILE_PIN
+            this->mark = mark;
+            if (mark)
+                digitalWrite(BUTTON_PROFILE_PIN, HIGH);
+#else
+            (void)mark;
+#endif
+            start = BUTTON_PROFILE_CLOCK();
+        }
+
+        ~Probe()
+        {
+            uint32_t spent = (uint32_t)(BUTTON_PROFILE_CLOCK() - start);
+#ifdef BUTTON_PROFILE_PIN
+            if (mark)
+                digitalWrite(BUTTON_PROFILE_PIN, LOW);
+#endif
+            if (!span.count || spent < span.min)
+                span.min = spent;
+            if (spent > span.max)
+                span.max = spent;
+            span.total += spent;
+            span.count++;
+        }
+
+    private:
+        AsyncButton::Span &span;
+        uint32_t start;
+#ifdef BUTTON_PROFILE_PIN
+        bool mark;
+#endif
     };
-    AsyncButton::Config ButtonConfig = {Buttons, sizeof(Buttons) / sizeof(AsyncButton::State)};
+#define ABUTTON_PROBE(span) Probe probe(conf.profile.span)
+#define ABUTTON_PROBE_MARK(span) Probe probe(conf.profile.span, true)
+
+    // Track the worst delay between an event's edge and its delivery to the sketch
+    static inline void delivered(AsyncButton::Config &conf, const AsyncButton::Event &event)
+    {
+        Time late = elapsed(timeOf(conf), event.time);
+        if (late > conf.profile.latency)
+            conf.profile.latency = late;
+    }
+
+    static void getProfile(const AsyncButton::Config &conf, AsyncButton::Profile &profile)
+    {
+        ABUTTON_GUARD;
+        profile = conf.profile;
+        AsyncButton::Span *spans[] = {&profile.update, &profile.query, &profile.reset};
+        for (auto *span : spans)
+            span->average = span->count ? span->total / span->count : 0;
+        unsigned long ms = (unsigned long)BUTTON_TIME() - profile.since;
+        profile.eventRate = ms ? (uint32_t)((uint64_t)profile.events * 1000 / ms) : 0;
+    }
+
+    static void resetProfile(AsyncButton::Config &conf)
+    {
+        memset(&conf.profile, 0, sizeof(conf.profile));
+        conf.profile.since = BUTTON_TIME();
+    }
+
+    void getProfile(AsyncButton::Profile &profile)
+    {
+        getProfile(*Current, profile);
+    }
+
+    void resetProfile()
+    {
+        resetProfile(*Current);
+    }
+#else
+#define ABUTTON_PROBE(span)
+#define ABUTTON_PROBE_MARK(span)
+#endif
+
+    static void clear(AsyncButton::State &button, AsyncButton::Time now)
+    {
+        button.state = RELEASED;
+        button.doublePress = false;
+        button.duration = 0;
+        button.last_time = 0;
+        button.lastReading = RELEASED;
+        button.lastChangeTime = now;
+        button.lastLongPressCallback = 0;
+#ifdef BUTTON_COMPACT_STATE
+        button.stale = true;
+#endif
+    }
+
+#ifdef BUTTON_EVENT_QUEUE
+    static inline uint8_t loadAcquire(const volatile uint8_t &value)
+    {
+#if defined(__AVR__)
+        return value; // Byte accesses are atomic on single-core AVR
+#else
+        return __atomic_load_n(&value, __ATOMIC_ACQUIRE);
+#endif
+    }
+
+    static inline void storeRelease(volatile uint8_t &value, uint8_t update)
+    {
+#if defined(__AVR__)
+        __asm__ __volatile__("" ::: "memory");
+        value = update;
+#else
+        __atomic_store_n(&value, update, __ATOMIC_RELEASE);
+#endif
+    }
+
+    static void push(AsyncButton::Config &conf, const AsyncButton::Event &event)
+    {
+        uint8_t head = conf.head;
+        uint8_t next = (head + 1) & (BUTTON_EVENT_QUEUE_SIZE - 1);
+        if (next == loadAcquire(conf.tail))
+        {
+            if (conf.dropped < 255)
+                conf.dropped++;
+            return;
+        }
+        conf.events[head] = event;
+        storeRelease(conf.head, next);
+    }
+
+    static bool poll(AsyncButton::Config &conf, AsyncButton::Event &event)
+    {
+        uint8_t tail = conf.tail;
+        if (tail == loadAcquire(conf.head))
+            return false;
+        event = conf.events[tail];
+        storeRelease(conf.tail, (tail + 1) & (BUTTON_EVENT_QUEUE_SIZE - 1));
+#ifdef BUTTON_PROFILE
+        delivered(conf, event);
+#endif
+        return true;
+    }
+
+    bool poll(AsyncButton::Event &event)
+    {
+        return poll(*Current, event);
+    }
+
+#ifdef ABUTTON_EDGES
+    // Queue an edge seen by the sampling path, false when the queue is full and the edge is left to the latched state
+    static inline bool IRAM_ATTR pushEdge(AsyncButton::Config &conf, uint8_t index, uint8_t level, AsyncButton::Time time)
+    {
+        uint8_t head = conf.edgeHead;
+        uint8_t next = (head + 1) & (BUTTON_EVENT_QUEUE_SIZE - 1);
+        if (next == loadAcquire(conf.edgeTail))
+            return false;
+        conf.edges[head] = {index, level, time};
+        storeRelease(conf.edgeHead, next);
+        return true;
+    }
+#endif
+#endif
+
+#ifdef BUTTON_HANDLERS
+    static bool on(AsyncButton::Config &conf, const uint8_t pin, uint16_t events, AsyncButton::EventCallback callback, void *context)
+    {
+        if (!callback || conf.handlerCount >= BUTTON_MAX_HANDLERS)
+            return false;
+        conf.handlers[conf.handlerCount++] = {pin, events, callback, context};
+        return true;
+    }
+
+    static void off(AsyncButton::Config &conf, const uint8_t pin, AsyncButton::EventCallback callback)
+    {
+        uint8_t kept = 0;
+        for (uint8_t h = 0; h < conf.handlerCount; ++h)
+            if (conf.handlers[h].pin != pin || conf.handlers[h].callback != callback)
+                conf.handlers[kept++] = conf.handlers[h];
+        conf.handlerCount = kept;
+    }
+
+    bool on(const uint8_t pin, uint16_t events, AsyncButton::EventCallback callback, void *context)
+    {
+        return on(*Current, pin, events, callback, context);
+    }
+
+    void off(const uint8_t pin, AsyncButton::EventCallback callback)
+    {
+        off(*Current, pin, callback);
+    }
+#endif
+
+#ifdef ABUTTON_EVENTS
+    static void emit(AsyncButton::Config &conf, uint8_t type, const uint8_t pin, AsyncButton::Time now, AsyncButton::Time duration, uint16_t count = 0)
+    {
+#if defined(BUTTON_REPEAT) || defined(BUTTON_GESTURES)
+        AsyncButton::Event event = {type, pin, now, duration, count};
+#else
+        (void)count;
+        AsyncButton::Event event = {type, pin, now, duration};
+#endif
+#ifdef BUTTON_PROFILE
+        conf.profile.events++;
+#endif
+#ifdef BUTTON_EVENT_QUEUE
+        push(conf, event);
+#endif
+#ifdef BUTTON_HANDLERS
+        for (uint8_t h = 0; h < conf.handlerCount; ++h)
+        {
+            const auto &handler = conf.handlers[h];
+            if ((handler.pin == pin || handler.pin == BUTTON_ANY_PIN) && (handler.events & BUTTON_EVENT_BIT(type)))
+            {
+#ifdef BUTTON_PROFILE
+                delivered(conf, event);
+#endif
+                handler.callback(event, handler.context);
+            }
+        }
+#endif
+    }
+#endif
+
+    static bool heldByMapper(const AsyncButton::Config &conf, const AsyncButton::State &button)
+    {
+        for (uint8_t m = button.firstMapper; m != 255; m = conf.buttons[m].nextMapper)
+            if (conf.buttons[m].state == PRESSED)
+                return true;
+#if BUTTON_MAX_MAPPINGS > 0
+        for (uint8_t l = button.firstLinked; l != 255; l = conf.mappings[l].nextIn)
+            if (conf.buttons[conf.mappings[l].from].state == PRESSED)
+                return true;
+#endif
+        return false;
+    }
+
+    static inline AsyncButton::Source *sourceOf(const AsyncButton::Config &conf, const uint8_t pin)
+    {
+        for (Source *source = conf.sources; source; source = source->next)
+            if ((uint8_t)(pin - source->base) < source->count)
+                return source;
+        return nullptr;
+    }
+
+    static AsyncButton::State *find(const AsyncButton::Config &conf, const uint8_t pin)
+    {
+        if (pin == 255)
+            return nullptr;
+#if BUTTON_PIN_TABLE_SIZE > 0
+        if (conf.indexed && pin < BUTTON_PIN_TABLE_SIZE)
+            return conf.index[pin] ? &conf.buttons[conf.index[pin] - 1] : nullptr;
+#endif
+        if (conf.sources)
+            if (Source *source = sourceOf(conf, pin))
+                if (source->first != 255)
+                {
+                    size_t i = source->first + (uint8_t)(pin - source->base); // Buttons of the source listed in key order
+                    return i < conf.size && conf.buttons[i].pin == pin ? &conf.buttons[i] : nullptr;
+                }
+        for (size_t i = 0; i < conf.size; ++i)
+            if (conf.buttons[i].pin == pin)
+                return &conf.buttons[i];
+        return nullptr;
+    }
+
+#ifdef BUTTON_CHORDS
+    // Bit of a button in the chord masks, 0 beyond the first 32 buttons
+    static inline uint32_t chordBit(const AsyncButton::Config &conf, const AsyncButton::State &button)
+    {
+        size_t i = &button - conf.buttons;
+        return i < 32 ? (uint32_t)1 << i : 0;
+    }
+
+    static inline void forget(AsyncButton::Config &conf, const AsyncButton::State &button)
+    {
+        uint32_t bit = chordBit(conf, button);
+        conf.pressed &= ~bit;
+        conf.swallowed &= ~bit;
+    }
+#endif
+
+#ifdef BUTTON_STATS
+    static inline void count(uint16_t &counter)
+    {
+        if (counter != 0xFFFF)
+            counter++; // Saturates instead of wrapping around
+    }
+
+    // Count a completed press and file its duration into the histogram
+    static void record(const AsyncButton::Config &conf, const AsyncButton::State &button, AsyncButton::Time duration, const AsyncButton::Timing &timing)
+    {
+        if (!conf.stats)
+            return;
+        auto &stats = conf.stats[&button - conf.buttons];
+        count(stats.presses);
+        if (duration > timing.longPress)
+            count(stats.longs);
+        if (button.doublePress)
+            count(stats.doubles);
+        uint8_t bin = 0;
+        for (Time span = duration / BUTTON_STATS_BIN_TIME; span && bin < BUTTON_STATS_BINS - 1; span >>= 1)
+            ++bin;
+        count(stats.durations[bin]);
+    }
+
+    static inline void bounced(const AsyncButton::Config &conf, size_t i)
+    {
+        if (conf.stats)
+            count(conf.stats[i].bounces);
+    }
+
+    // Live counters, nullptr from outside a running scan task
+    static const AsyncButton::Stats *getStats(const AsyncButton::Config &conf, const uint8_t pin)
+    {
+#ifdef BUTTON_RTOS
+        if (offTask(conf))
+            return nullptr;
+#endif
+        State *button = find(conf, pin);
+        return button && conf.stats ? &conf.stats[button - conf.buttons] : nullptr;
+    }
+
+    static void resetStats(AsyncButton::Config &conf)
+    {
+        ABUTTON_GUARD;
+        if (!conf.stats)
+            return;
+#ifdef BUTTON_TIMER
+        uint8_t saved = lock(); // tick() counts the bounces of the timer-sampled buttons
+        memset(conf.stats, 0, conf.size * sizeof(Stats));
+        unlock(saved);
+#else
+        memset(conf.stats, 0, conf.size * sizeof(Stats));
+#endif
+    }
+
+    const AsyncButton::Stats *getStats(const uint8_t pin)
+    {
+        return getStats(*Current, pin);
+    }
+
+    void resetStats()
+    {
+        resetStats(*Current);
+    }
+#endif
+
+    // Clear a button and the buttons mapping to it, down to the start of each chain
+    static void clearChain(AsyncButton::Config &conf, AsyncButton::State &button, AsyncButton::Time now)
+    {
+        clear(button, now);
+#ifdef BUTTON_CHORDS
+        forget(conf, button);
+#endif
+        for (uint8_t m = button.firstMapper; m != 255; m = conf.buttons[m].nextMapper)
+            clearChain(conf, conf.buttons[m], now);
+#if BUTTON_MAX_MAPPINGS > 0
+        for (uint8_t l = button.firstLinked; l != 255; l = conf.mappings[l].nextIn)
+            clearChain(conf, conf.buttons[conf.mappings[l].from], now);
+#endif
+    }
+
+    static void reset(AsyncButton::Config &conf, const uint8_t pin)
+    {
+        ABUTTON_PROBE(reset);
+        State *button = find(conf, pin);
+        if (!button)
+            return;
+        clearChain(conf, *button, conf.now);
+    }
+
+    static void buildIndex(AsyncButton::Config &conf)
+    {
+#if BUTTON_PIN_TABLE_SIZE > 0
+        memset(conf.index, 0, sizeof(conf.index));
+        for (size_t i = 0; i < conf.size && i < 255; ++i)
+        {
+            uint8_t pin = conf.buttons[i].pin;
+            if (pin < BUTTON_PIN_TABLE_SIZE && !conf.index[pin])
+                conf.index[pin] = i + 1;
+        }
+        conf.indexed = true;
+#endif
+        // Virtual pins lie beyond the table, a source whose buttons are listed in key order finds them by offset
+        for (Source *source = conf.sources; source; source = source->next)
+        {
+            uint8_t first = 255;
+            for (size_t i = 0; i < conf.size; ++i)
+            {
+                uint8_t key = conf.buttons[i].pin - source->base;
+                if (key >= source->count)
+                    continue;
+                if (first == 255 && i >= key && i - key < 255)
+                    first = i - key;
+                else if (i != (size_t)first + key)
+                {
+                    first = 255; // Out of key order, found by a scan
+                    break;
+                }
+            }
+            source->first = first;
+        }
+    }
+
+    // Whether button to is reachable from button from over the edges kept so far, walking each button once
+    static bool reaches(const AsyncButton::Config &conf, uint8_t from, uint8_t to, uint8_t *seen)
+    {
+        if (from == to)
+            return true;
+        if (seen[from >> 3] & 1 << (from & 7))
+            return false;
+        seen[from >> 3] |= 1 << (from & 7);
+        const State &button = conf.buttons[from];
+        if (button.mappedIndex != 255 && reaches(conf, button.mappedIndex, to, seen))
+            return true;
+#if BUTTON_MAX_MAPPINGS > 0
+        for (uint8_t l = button.firstLink; l != 255; l = conf.mappings[l].nextOut)
+            if (reaches(conf, conf.mappings[l].to, to, seen))
+                return true;
+#endif
+        return false;
+    }
+
+    // Edge from source to target is kept unless it repeats a kept edge or closes a cycle
+    static bool linkable(const AsyncButton::Config &conf, const AsyncButton::State *source, const AsyncButton::State *target)
+    {
+        if (!source || !target || source == target || source - conf.buttons >= 255 || target - conf.buttons >= 255)
+            return false;
+        uint8_t from = source - conf.buttons, to = target - conf.buttons;
+        if (source->mappedIndex == to)
+            return false;
+#if BUTTON_MAX_MAPPINGS > 0
+        for (uint8_t l = source->firstLink; l != 255; l = conf.mappings[l].nextOut)
+            if (conf.mappings[l].to == to)
+                return false;
+#endif
+        uint8_t seen[32] = {0};
+        return !reaches(conf, to, from, seen);
+    }
+
+    // Compile the mappings once per setup(), mappedPin edges in button order first, then the addMapping() entries.
+    // Each kept mappedPin becomes the mappedIndex of its button and joins the mapper list of its target, each kept
+    // entry joins the list of its mapping button and the list of its target, so a press or release only walks its own lists
+    static void buildGraph(AsyncButton::Config &conf)
+    {
+        for (size_t i = 0; i < conf.size; ++i)
+        {
+            auto &button = conf.buttons[i];
+            button.mappedIndex = button.firstMapper = button.nextMapper = 255;
+#ifndef BUTTON_COMPACT_STATE
+            button.mappedState = nullptr;
+#endif
+#if BUTTON_MAX_MAPPINGS > 0
+            button.firstLink = button.firstLinked = 255;
+#endif
+        }
+        size_t count = conf.size < 255 ? conf.size : 255;
+        for (size_t i = 0; i < count; ++i)
+        {
+            auto &button = conf.buttons[i];
+            const State *target = button.pin == 255 ? nullptr : find(conf, button.mappedPin);
+            if (!linkable(conf, &button, target))
+                continue;
+            button.mappedIndex = target - conf.buttons;
+#ifndef BUTTON_COMPACT_STATE
+            button.mappedState = &conf.buttons[button.mappedIndex];
+#endif
+        }
+#if BUTTON_MAX_MAPPINGS > 0
+        for (uint8_t l = 0; l < conf.mappingCount; ++l)
+        {
+            auto &mapping = conf.mappings[l];
+            const State *source = find(conf, mapping.pin), *target = find(conf, mapping.target);
+            mapping.from = 255;
+            if (!linkable(conf, source, target))
+                continue;
+            mapping.from = source - conf.buttons;
+            mapping.to = target - conf.buttons;
+            mapping.nextOut = conf.buttons[mapping.from].firstLink;
+            conf.buttons[mapping.from].firstLink = l;
+        }
+        for (size_t i = 0; i < count; ++i)
+            conf.buttons[i].firstLink = 255;
+#endif
+        // Chain the lists backwards, so each one ends up in button and call order
+        for (size_t i = count; i-- > 0;)
+        {
+            auto &button = conf.buttons[i];
+            if (button.mappedIndex == 255)
+                continue;
+            button.nextMapper = conf.buttons[button.mappedIndex].firstMapper;
+            conf.buttons[button.mappedIndex].firstMapper = i;
+        }
+#if BUTTON_MAX_MAPPINGS > 0
+        for (uint8_t l = conf.mappingCount; l-- > 0;)
+        {
+            auto &mapping = conf.mappings[l];
+            if (mapping.from == 255)
+                continue;
+            mapping.nextOut = conf.buttons[mapping.from].firstLink;
+            conf.buttons[mapping.from].firstLink = l;
+            mapping.nextIn = conf.buttons[mapping.to].firstLinked;
+            conf.buttons[mapping.to].firstLinked = l;
+        }
+#endif
+    }
+
+    bool addMapping(AsyncButton::Config &conf, const uint8_t pin, const uint8_t target)
+    {
+#if BUTTON_MAX_MAPPINGS > 0
+        ABUTTON_GUARD;
+        if (conf.mappingCount >= BUTTON_MAX_MAPPINGS)
+            return false;
+        conf.mappings[conf.mappingCount++] = {pin, target, 255, 255, 255, 255}; // Linked by the next setup()
+        return true;
+#else
+        (void)conf;
+        (void)pin;
+        (void)target;
+        return false;
+#endif
+    }
+
+#ifdef BUTTON_CHORDS
+    uint8_t addChord(AsyncButton::Config &conf, const uint8_t *pins, uint8_t count, unsigned long hold, uint8_t flags)
+    {
+        if (conf.chordCount >= BUTTON_MAX_CHORDS || !count)
+            return 255;
+        uint32_t mask = 0;
+        for (uint8_t p = 0; p < count; ++p)
+        {
+            State *button = find(conf, pins[p]);
+            uint32_t bit = button ? chordBit(conf, *button) : 0;
+            if (!bit)
+                return 255; // Unknown pin or beyond the first 32 buttons
+            mask |= bit;
+        }
+        auto &chord = conf.chords[conf.chordCount];
+        chord.mask = mask;
+        chord.hold = (Time)hold;
+        chord.since = 0;
+        chord.flags = flags;
+        chord.held = chord.fired = chord.pending = false;
+        return conf.chordCount++;
+    }
+
+    // Match every chord against the pressed buttons with a single mask compare
+    static void chords(AsyncButton::Config &conf, AsyncButton::Time now)
+    {
+        for (uint8_t c = 0; c < conf.chordCount; ++c)
+        {
+            auto &chord = conf.chords[c];
+            if ((conf.pressed & chord.mask) != chord.mask)
+            {
+                chord.held = chord.fired = false;
+                continue;
+            }
+            if (!chord.held)
+            {
+                chord.held = true;
+                chord.since = now;
+            }
+            if (chord.fired)
+                continue;
+            if (elapsed(now, chord.since) < chord.hold)
+            {
+                due(conf, chord.hold - elapsed(now, chord.since));
+                continue;
+            }
+            chord.fired = chord.pending = true;
+            if (chord.flags & BUT_SWALLOW)
+                conf.swallowed |= chord.mask;
+#ifdef ABUTTON_EVENTS
+            emit(conf, BUTTON_EVENT_CHORD, c, now, elapsed(now, chord.since));
+#endif
+        }
+    }
+
+    static bool isChord(AsyncButton::Config &conf, uint8_t chord, bool reset)
+    {
+        ABUTTON_GUARD;
+        if (chord >= conf.chordCount || !conf.chords[chord].pending)
+            return false;
+        if (reset)
+            conf.chords[chord].pending = false;
+        return true;
+    }
+
+    bool isChord(uint8_t chord, bool reset)
+    {
+        return isChord(*Current, chord, reset);
+    }
+#endif
+
+#ifdef BUTTON_REPEAT
+    uint8_t addRepeat(AsyncButton::Config &conf, const uint8_t pin, unsigned long delay, unsigned long rate, unsigned long fastest, uint8_t accel, AsyncButton::RepeatCallback callback)
+    {
+        State *button = find(conf, pin);
+        if (conf.repeatCount >= BUTTON_MAX_REPEATS || !button || button - conf.buttons >= 255 || !rate)
+            return 255;
+        auto &repeat = conf.repeats[conf.repeatCount];
+        repeat.button = button - conf.buttons;
+        repeat.delay = (Time)delay;
+        repeat.rate = (Time)rate;
+        repeat.fastest = (Time)(fastest && fastest < rate ? fastest : rate);
+        repeat.accel = accel < 100 ? accel : 99;
+        repeat.callback = callback;
+        repeat.since = repeat.wait = 0;
+        repeat.count = 0;
+        conf.repeating &= ~(1u << conf.repeatCount);
+        return conf.repeatCount++;
+    }
+
+    // Start the repeats of a button at its press edge
+    static void arm(AsyncButton::Config &conf, const AsyncButton::State &button, AsyncButton::Time now)
+    {
+        uint8_t index = &button - conf.buttons;
+        for (uint8_t r = 0; r < conf.repeatCount; ++r)
+        {
+            auto &repeat = conf.repeats[r];
+            if (repeat.button != index)
+                continue;
+            repeat.since = now;
+            repeat.wait = repeat.delay;
+            repeat.count = 0;
+            conf.repeating |= 1u << r;
+        }
+    }
+
+    // Fire the repeats that came due, only the buttons held since their press edge are visited
+    static void repeats(AsyncButton::Config &conf, AsyncButton::Time now)
+    {
+        for (uint8_t r = 0, held = conf.repeating; held; ++r, held >>= 1)
+        {
+            if (!(held & 1))
+                continue;
+            auto &repeat = conf.repeats[r];
+            const auto &button = conf.buttons[repeat.button];
+#ifdef BUTTON_CHORDS
+            if (button.state != PRESSED || (conf.swallowed & chordBit(conf, button)))
+#else
+            if (button.state != PRESSED)
+#endif
+            {
+                conf.repeating &= ~(1u << r); // Released, reset or taken by a chord
+                continue;
+            }
+            Time since = elapsed(now, repeat.since);
+            if (since < repeat.wait)
+            {
+                due(conf, repeat.wait - since);
+                continue;
+            }
+            // Keep the cadence, unless update() fell behind by more than an interval
+            repeat.since = since - repeat.wait < repeat.wait ? (Time)(repeat.since + repeat.wait) : now;
+            if (repeat.count != 0xFFFF)
+                repeat.count++;
+            if (repeat.count == 1)
+                repeat.wait = repeat.rate;
+            else
+            {
+                Time shorter = repeat.wait - (Time)((uint32_t)repeat.wait * repeat.accel / 100);
+                repeat.wait = shorter > repeat.fastest ? shorter : repeat.fastest;
+            }
+            since = elapsed(now, repeat.since);
+            due(conf, since < repeat.wait ? repeat.wait - since : 0);
+            // Copy the fields first, callbacks may reset the button
+            uint8_t pin = button.pin;
+            uint16_t count = repeat.count;
+#ifdef ABUTTON_EVENTS
+            emit(conf, BUTTON_EVENT_REPEAT, pin, now, elapsed(now, button.last_time), count);
+#endif
+            if (repeat.callback)
+                repeat.callback(pin, count);
+        }
+    }
+#endif
+
+#ifdef BUTTON_GESTURES
+    static uint8_t addNode(AsyncButton::Config &conf)
+    {
+        auto &node = conf.nodes[conf.nodeCount];
+        node.next[0] = node.next[1] = 0;
+        node.gesture = 255;
+        return conf.nodeCount++;
+    }
+
+    // Compile the pattern into the button's transition table, sharing the states of common prefixes
+    uint8_t addGesture(AsyncButton::Config &conf, const uint8_t pin, const char *pattern, AsyncButton::GestureCallback callback)
+    {
+        State *button = find(conf, pin);
+        if (conf.gestureCount >= BUTTON_MAX_GESTURES || !button || button - conf.buttons >= 255 || !pattern || !*pattern)
+            return 255;
+        size_t length = 0;
+        for (; pattern[length]; ++length)
+            if (pattern[length] != '.' && pattern[length] != '-')
+                return 255;
+        uint8_t index = button - conf.buttons, s = 0;
+        while (s < conf.sequenceCount && conf.sequences[s].button != index)
+            ++s;
+        bool fresh = s == conf.sequenceCount;
+        if (fresh && s >= BUTTON_MAX_GESTURE_BUTTONS)
+            return 255;
+        // Follow the prefix already in the table, then check the missing states fit before adding any
+        size_t depth = 0;
+        uint8_t node = fresh ? 0 : conf.sequences[s].root;
+        if (!fresh)
+            while (depth < length && conf.nodes[node].next[pattern[depth] == '-'])
+                node = conf.nodes[node].next[pattern[depth++] == '-'];
+        if (length - depth + fresh > (size_t)(BUTTON_MAX_GESTURE_NODES - conf.nodeCount))
+            return 255;
+        if (depth == length && conf.nodes[node].gesture != 255)
+            return 255; // Added before
+        if (fresh)
+        {
+            auto &sequence = conf.sequences[conf.sequenceCount++];
+            sequence.button = index;
+            sequence.root = sequence.node = node = addNode(conf);
+            sequence.since = 0;
+            conf.sequencing &= ~(1u << s);
+        }
+        for (; depth < length; ++depth)
+        {
+            uint8_t next = addNode(conf); // Never 0, the first node is a root
+            conf.nodes[node].next[pattern[depth] == '-'] = next;
+            node = next;
+        }
+        conf.nodes[node].gesture = conf.gestureCount;
+        auto &gesture = conf.gestures[conf.gestureCount];
+        gesture.button = index;
+        gesture.callback = callback;
+        conf.recognized &= ~(1u << conf.gestureCount);
+        return conf.gestureCount++;
+    }
+
+    // End a sequence, reporting the pattern it completed
+    static void finish(AsyncButton::Config &conf, uint8_t s, AsyncButton::Time now)
+    {
+        const auto &sequence = conf.sequences[s];
+        conf.sequencing &= ~(1u << s);
+        if (sequence.node == 255 || conf.nodes[sequence.node].gesture == 255)
+            return;
+        uint8_t g = conf.nodes[sequence.node].gesture;
+        conf.recognized |= 1u << g;
+        // Copy the fields first, callbacks may reset the button
+        uint8_t pin = conf.buttons[sequence.button].pin;
+        GestureCallback callback = conf.gestures[g].callback;
+#ifdef ABUTTON_EVENTS
+        emit(conf, BUTTON_EVENT_GESTURE, pin, now, 0, g);
+#else
+        (void)now;
+#endif
+        if (callback)
+            callback(pin, g);
+    }
+
+    // Take the transition of a released press, one table lookup per press and no press history
+    static void advance(AsyncButton::Config &conf, const AsyncButton::State &button, AsyncButton::Time now, const AsyncButton::Timing &timing)
+    {
+        uint8_t index = &button - conf.buttons;
+        for (uint8_t s = 0; s < conf.sequenceCount; ++s)
+        {
+            auto &sequence = conf.sequences[s];
+            if (sequence.button != index)
+                continue;
+            uint8_t bit = 1u << s;
+            if ((conf.sequencing & bit) && elapsed(button.last_time, sequence.since) >= timing.doubleClick)
+                finish(conf, s, now); // Pressed after the pause, update() was not called in between
+            uint8_t node = conf.sequencing & bit ? sequence.node : sequence.root;
+            if (node != 255)
+            {
+                node = conf.nodes[node].next[button.duration > timing.longPress];
+                sequence.node = node ? node : 255;
+            }
+            sequence.since = now;
+            conf.sequencing |= bit;
+            return;
+        }
+    }
+
+    // Close the sequences whose pause ran out, and at once those no further press can extend
+    static void gestures(AsyncButton::Config &conf, AsyncButton::Time now)
+    {
+        const Timing &shared = timingOf(conf);
+        for (uint8_t s = 0, open = conf.sequencing; open; ++s, open >>= 1)
+        {
+            if (!(open & 1))
+                continue;
+            const auto &sequence = conf.sequences[s];
+            const auto &button = conf.buttons[sequence.button];
+            Time window = timingOf(button, shared).doubleClick;
+            if (button.state == PRESSED && elapsed(button.last_time, sequence.since) < window)
+                continue; // The next press is under way, its release takes the next transition
+            uint8_t node = sequence.node;
+            bool complete = node != 255 && !conf.nodes[node].next[0] && !conf.nodes[node].next[1];
+            Time pause = elapsed(now, sequence.since);
+            if (!complete && pause < window)
+            {
+                due(conf, window - pause);
+                continue;
+            }
+            finish(conf, s, now);
+        }
+    }
+
+    static bool isGesture(AsyncButton::Config &conf, uint8_t gesture, bool reset)
+    {
+        ABUTTON_GUARD;
+        if (gesture >= conf.gestureCount || !(conf.recognized & (1u << gesture)))
+            return false;
+        if (reset)
+            conf.recognized &= ~(1u << gesture);
+        return true;
+    }
+
+    bool isGesture(uint8_t gesture, bool reset)
+    {
+        return isGesture(*Current, gesture, reset);
+    }
+#endif
+
+#ifdef BUTTON_PORT_READ
+    static uint8_t portSlot(AsyncButton::Config &conf, const uint8_t pin, PortWord &mask)
+    {
+        const volatile PortWord *reg = (const volatile PortWord *)portInputRegister(digitalPinToPort(pin));
+        mask = (PortWord)digitalPinToBitMask(pin);
+        if (!reg || !mask)
+            return 0;
+        for (uint8_t p = 0; p < conf.portCount; ++p)
+            if (conf.ports[p] == reg)
+                return p + 1;
+        if (conf.portCount >= BUTTON_MAX_PORTS)
+            return 0;
+        conf.ports[conf.portCount++] = reg;
+        return conf.portCount;
+    }
+#endif
+
+    bool attach(AsyncButton::Config &conf, AsyncButton::Source &source)
+    {
+        if (!source.count || source.base + source.count > 255)
+            return false;
+        Source **tail = &conf.sources;
+        for (; *tail; tail = &(*tail)->next)
+        {
+            if (*tail == &source)
+                return true;
+            if (source.base < (*tail)->base + (*tail)->count && (*tail)->base < source.base + source.count)
+                return false; // Overlapping virtual pins
+        }
+        source.next = nullptr;
+        source.first = 255; // Indexed by the next setup()
+        *tail = &source;
+        return true;
+    }
+
+    static inline uint8_t readPin(const AsyncButton::Config &conf, const AsyncButton::State &button, const void *sample)
+    {
+#ifdef BUTTON_RECORD
+        if (conf.tape && conf.tape->replaying)
+        {
+            size_t i = &button - conf.buttons;
+            return i < 32 && (conf.tape->levels & ((uint32_t)1 << i)) ? PRESSED : RELEASED;
+        }
+#endif
+#ifdef BUTTON_PORT_READ
+        if (button.port)
+            return (((const PortWord *)sample)[button.port - 1] & button.mask) ? HIGH : LOW;
+#else
+        (void)sample;
+#endif
+        if (conf.sources)
+            if (Source *source = sourceOf(conf, button.pin))
+                return source->read(button.pin - source->base);
+        return digitalRead(button.pin);
+    }
+
+#ifdef BUTTON_RECORD
+#ifdef BUTTON_INTERRUPT
+    // Buttons among the first 32 with a pin, all of them are looked at once the readings change under them
+    static uint32_t present(const AsyncButton::Config &conf)
+    {
+        uint32_t mask = 0;
+        for (size_t i = 0; i < conf.size && i < 32; ++i)
+            if (conf.buttons[i].pin != 255)
+                mask |= (uint32_t)1 << i;
+        return mask;
+    }
+#endif
+
+    // Append a debounced edge to the tape, overwriting the oldest mark once it is full
+    static void capture(AsyncButton::Config &conf, const AsyncButton::State &button, uint8_t reading, AsyncButton::Time now)
+    {
+        Tape *tape = conf.tape;
+        if (!tape || tape->replaying || !tape->size)
+            return;
+        Time delta = tape->count ? elapsed(now, tape->last) : 0;
+        auto &mark = tape->marks[tape->head];
+        mark.delta = (uint16_t)(delta < 0x7FFF ? delta : 0x7FFF) | (reading == PRESSED ? 0x8000 : 0);
+        mark.pin = button.pin;
+        tape->last = now;
+        tape->head = tape->head + 1 < tape->size ? tape->head + 1 : 0;
+        if (tape->count < tape->size)
+            tape->count++;
+    }
+
+    static void stop(AsyncButton::Config &conf)
+    {
+        if (!conf.tape || !conf.tape->replaying)
+            return;
+        conf.tape->replaying = false;
+        conf.deadline = 0; // Back to the live pins
+#ifdef BUTTON_INTERRUPT
+        conf.active |= present(conf);
+#endif
+    }
+
+    void record(AsyncButton::Config &conf, AsyncButton::Tape *tape)
+    {
+        stop(conf);
+        conf.tape = tape;
+        if (!tape)
+            return;
+        tape->head = tape->count = tape->cursor = 0;
+        tape->levels = 0;
+        tape->replaying = false;
+    }
+
+    // Start feeding the recorded edges to update() from its oldest mark on, in place of the pins
+    bool replay(AsyncButton::Config &conf, AsyncButton::Tape *tape)
+    {
+        stop(conf);
+        conf.tape = tape;
+        if (!tape || !tape->count)
+            return false;
+        tape->cursor = 0;
+        tape->levels = 0;
+        tape->last = timeOf(conf);
+        tape->replaying = true;
+        conf.deadline = 0; // The oldest mark plays at the next update()
+#ifdef BUTTON_INTERRUPT
+        conf.active |= present(conf);
+#endif
+        return true;
+    }
+
+    // Apply the marks that came due, returns the buttons whose replayed reading changed
+    static uint32_t replay(AsyncButton::Config &conf, AsyncButton::Time now)
+    {
+        Tape &tape = *conf.tape;
+        uint32_t changed = 0;
+        for (; tape.cursor < tape.count; ++tape.cursor)
+        {
+            uint16_t slot = tape.head + tape.size - tape.count + tape.cursor;
+            const auto &mark = tape.marks[slot < tape.size ? slot : slot - tape.size];
+            Time delta = tape.cursor ? mark.delta & 0x7FFF : 0; // The oldest mark plays at once
+            Time since = elapsed(now, tape.last);
+            if (since < delta)
+            {
+                due(conf, delta - since);
+                return changed;
+            }
+            tape.last += delta; // Keep the recorded spacing even when update() runs late
+            State *button = find(conf, mark.pin);
+            size_t i = button ? button - conf.buttons : 32;
+            if (i >= 32)
+                continue;
+            if (mark.delta & 0x8000)
+                tape.levels |= (uint32_t)1 << i;
+            else
+                tape.levels &= ~((uint32_t)1 << i);
+            changed |= (uint32_t)1 << i;
+        }
+        for (size_t i = 0; i < conf.size && i < 32; ++i)
+            if (conf.buttons[i].pin != 255 && (conf.buttons[i].state == PRESSED) != ((tape.levels >> i) & 1))
+                return changed; // The last edges are still debouncing
+        stop(conf); // End of the tape, back to the live pins without recording
+        conf.tape = nullptr;
+        return changed;
+    }
+
+    bool isReplaying()
+    {
+        return Current->tape && Current->tape->replaying;
+    }
+#endif
+
+#ifdef BUTTON_ENCODERS
+    bool attach(AsyncButton::Config &conf, AsyncButton::Encoder *encoders, uint8_t count)
+    {
+        for (uint8_t e = 0; e < count; ++e)
+        {
+            uint8_t steps = encoders[e].steps;
+            if (encoders[e].pinA == 255 || encoders[e].pinB == 255 || (steps != 1 && steps != 2 && steps != 4))
+                return false;
+        }
+        conf.encoders = count ? encoders : nullptr;
+        conf.encoderCount = conf.encoders ? count : 0;
+        return true;
+    }
+
+    // Direction of each A/B transition, indexed by the previous phase and the new one, 0 for none or a skipped phase
+    static const DRAM_ATTR int8_t Quadrature[16] = {0, -1, 1, 0, 1, 0, 0, -1, -1, 0, 0, 1, 0, 1, -1, 0};
+
+    static inline void IRAM_ATTR turned(AsyncButton::Encoder &encoder, int16_t detents)
+    {
+#if defined(__AVR__)
+        encoder.pending += detents; // Taken with interrupts off
+#else
+        __atomic_fetch_add(&encoder.pending, detents, __ATOMIC_RELAXED);
+#endif
+    }
+
+    // Feed one A/B reading to the decoder, a detent is counted once steps transitions agree
+    static void IRAM_ATTR turn(AsyncButton::Encoder &encoder, uint8_t phase)
+    {
+        int8_t direction = Quadrature[(encoder.phase << 2) | phase];
+        encoder.phase = phase;
+        if (!direction)
+            return;
+        int8_t sub = encoder.sub + direction;
+        if (sub >= (int8_t)encoder.steps || sub <= -(int8_t)encoder.steps)
+        {
+            turned(encoder, sub > 0 ? 1 : -1);
+            sub = 0;
+        }
+        else if (phase == 3)
+            sub = 0; // Back at rest with both contacts open, drop a partial detent
+        encoder.sub = sub;
+    }
+
+    static inline uint8_t IRAM_ATTR readPhase(const AsyncButton::Encoder &encoder)
+    {
+        return (digitalRead(encoder.pinA) == HIGH ? 2 : 0) | (digitalRead(encoder.pinB) == HIGH ? 1 : 0);
+    }
+
+    static uint8_t phaseOf(const AsyncButton::Config &conf, const AsyncButton::Encoder &encoder, const void *sample)
+    {
+#ifdef BUTTON_PORT_READ
+        if (sample && encoder.portA && encoder.portB)
+        {
+            const PortWord *ports = (const PortWord *)sample;
+            return (ports[encoder.portA - 1] & encoder.maskA ? 2 : 0) | (ports[encoder.portB - 1] & encoder.maskB ? 1 : 0);
+        }
+#else
+        (void)sample;
+#endif
+        if (conf.sources)
+        {
+            Source *a = sourceOf(conf, encoder.pinA), *b = sourceOf(conf, encoder.pinB);
+            if (a || b)
+                return ((a ? a->read(encoder.pinA - a->base) : digitalRead(encoder.pinA)) == HIGH ? 2 : 0) |
+                       ((b ? b->read(encoder.pinB - b->base) : digitalRead(encoder.pinB)) == HIGH ? 1 : 0);
+        }
+        return readPhase(encoder);
+    }
+
+    static inline int16_t takeTurns(AsyncButton::Encoder &encoder)
+    {
+#if defined(__AVR__)
+        uint8_t sreg = SREG;
+        cli();
+        int16_t detents = encoder.pending;
+        encoder.pending = 0;
+        SREG = sreg;
+        return detents;
+#else
+        return __atomic_exchange_n(&encoder.pending, 0, __ATOMIC_ACQ_REL);
+#endif
+    }
+
+    // Decode the encoders not served by interrupts and collect the detents of all of them
+    static void encoders(AsyncButton::Config &conf, const void *sample, AsyncButton::Time now)
+    {
+#ifndef ABUTTON_EVENTS
+        (void)now;
+#endif
+        for (uint8_t e = 0; e < conf.encoderCount; ++e)
+        {
+            auto &encoder = conf.encoders[e];
+            if (!encoder.watched)
+                turn(encoder, phaseOf(conf, encoder, sample));
+            int16_t detents = encoder.pending ? takeTurns(encoder) : 0;
+            if (!detents)
+                continue;
+            encoder.delta += detents;
+#ifdef ABUTTON_EVENTS
+            uint8_t pin = encoder.pinA;
+            for (; detents > 0; --detents)
+                emit(conf, BUTTON_EVENT_TURN_CW, pin, now, 0);
+            for (; detents < 0; ++detents)
+                emit(conf, BUTTON_EVENT_TURN_CCW, pin, now, 0);
+#endif
+        }
+    }
+
+    static int16_t readEncoder(AsyncButton::Config &conf, uint8_t encoder, bool reset)
+    {
+        ABUTTON_GUARD;
+        if (encoder >= conf.encoderCount)
+            return 0;
+        int16_t delta = conf.encoders[encoder].delta;
+        if (reset)
+            conf.encoders[encoder].delta = 0;
+        return delta;
+    }
+
+    int16_t readEncoder(uint8_t encoder, bool reset)
+    {
+        return readEncoder(*Current, encoder, reset);
+    }
+#endif
+
+#ifdef BUTTON_INTERRUPT
+    static volatile uint32_t dirtyMask = 0;  // Buttons whose pin changed since the last update()
+    static volatile Time changeTimes[32];    // Time of the latest latched pin change of each button
+#ifdef ABUTTON_EDGES
+    static volatile uint8_t changeLevels[32]; // Pin level of each button after its latest latched change
+#endif
+    static AsyncButton::Config *watching = nullptr; // Config owning the pin change interrupts
+
+    static inline void IRAM_ATTR setDirty(uint32_t mask)
+    {
+#if defined(__AVR__)
+        dirtyMask |= mask; // AVR interrupts do not nest
+#else
+        __atomic_fetch_or(&dirtyMask, mask, __ATOMIC_RELEASE); // Publishes the change times with the bits
+#endif
+    }
+
+#ifdef ABUTTON_EDGES
+    // Latch a pin change of button i, queueing the level it left when that level outlasted the debounce time
+    static inline void IRAM_ATTR latch(uint8_t i, Time now, bool bank)
+    {
+        AsyncButton::Config &conf = *watching;
+        uint8_t level = digitalRead(conf.buttons[i].pin);
+        uint8_t left = changeLevels[i];
+        if (bank && level == left)
+            return; // Another pin of the bank changed
+        Time since = changeTimes[i];
+        Time debounce = timingOf(conf.buttons[i], timingOf(conf)).debounce;
+        if (elapsed(now, since) > debounce)
+            pushEdge(conf, i, left, since + debounce);
+        changeLevels[i] = level;
+        changeTimes[i] = now;
+    }
+#endif
+
+    // Latch a pin change of the buttons in mask, a pin change interrupt bank stamps all of its buttons
+    static inline void IRAM_ATTR markDirty(uint32_t mask)
+    {
+        Time now = (Time)BUTTON_TIME();
+        uint8_t i = 0;
+        for (uint32_t bits = mask; bits; bits >>= 1, ++i)
+            if (bits & 1)
+#ifdef ABUTTON_EDGES
+                latch(i, now, true);
+#else
+                changeTimes[i] = now;
+#endif
+        setDirty(mask);
+    }
+
+    static inline uint32_t takeDirty()
+    {
+#if defined(__AVR__)
+        uint8_t sreg = SREG;
+        cli();
+        uint32_t mask = dirtyMask;
+        dirtyMask = 0;
+        SREG = sreg;
+        return mask;
+#else
+        return __atomic_exchange_n(&dirtyMask, 0, __ATOMIC_ACQ_REL);
+#endif
+    }
+
+    // Latched change time of button i, never later than now
+    static inline AsyncButton::Time changeTime(size_t i, AsyncButton::Time now)
+    {
+#if defined(__AVR__)
+        uint8_t sreg = SREG;
+        cli();
+        Time time = changeTimes[i];
+        SREG = sreg;
+#else
+        Time time = changeTimes[i];
+#endif
+        return elapsed(time, now) < elapsed(now, time) ? now : time; // Changed again after this update read the clock
+    }
+
+    template <uint8_t N>
+    static void IRAM_ATTR pinChanged()
+    {
+#ifdef ABUTTON_EDGES
+        latch(N, (Time)BUTTON_TIME(), false);
+#else
+        changeTimes[N] = (Time)BUTTON_TIME();
+#endif
+        setDirty((uint32_t)1 << N);
+    }
+
+#define ABUTTON_ISR4(n) pinChanged<n>, pinChanged<n + 1>, pinChanged<n + 2>, pinChanged<n + 3>
+    static void (*const pinHandlers[32])() = {
+        ABUTTON_ISR4(0), ABUTTON_ISR4(4), ABUTTON_ISR4(8), ABUTTON_ISR4(12),
+        ABUTTON_ISR4(16), ABUTTON_ISR4(20), ABUTTON_ISR4(24), ABUTTON_ISR4(28)};
+
+#ifdef ABUTTON_PCINT
+    static volatile uint32_t pcintButtons[ABUTTON_PCINT]; // Buttons served by each pin change interrupt bank
+
+    static bool watchPcint(size_t i, uint8_t pin)
+    {
+        volatile uint8_t *pcicr = digitalPinToPCICR(pin);
+        uint8_t bank = digitalPinToPCICRbit(pin);
+        if (!pcicr || bank >= ABUTTON_PCINT)
+            return false;
+        pcintButtons[bank] |= (uint32_t)1 << i;
+        *digitalPinToPCMSK(pin) |= _BV(digitalPinToPCMSKbit(pin));
+        *pcicr |= _BV(bank);
+        return true;
+    }
+
+    static void unwatchPcint(size_t i, uint8_t pin)
+    {
+        volatile uint8_t *pcicr = digitalPinToPCICR(pin);
+        uint8_t bank = digitalPinToPCICRbit(pin);
+        if (!pcicr || bank >= ABUTTON_PCINT)
+            return;
+        pcintButtons[bank] &= ~((uint32_t)1 << i);
+        *digitalPinToPCMSK(pin) &= ~_BV(digitalPinToPCMSKbit(pin));
+    }
+#endif
+
+    static void watch(AsyncButton::Config &conf, size_t i)
+    {
+        uint8_t pin = conf.buttons[i].pin;
+        if (i >= 32)
+            return;
+#ifdef ABUTTON_EDGES
+        changeLevels[i] = digitalRead(pin);
+        changeTimes[i] = (Time)BUTTON_TIME();
+#endif
+        int irq = digitalPinToInterrupt(pin);
+        if (irq != NOT_AN_INTERRUPT)
+        {
+            attachInterrupt(irq, pinHandlers[i], CHANGE);
+            conf.watched |= (uint32_t)1 << i;
+            return;
+        }
+#ifdef ABUTTON_PCINT
+        if (watchPcint(i, pin))
+            conf.watched |= (uint32_t)1 << i;
+#endif
+    }
+
+#ifdef BUTTON_ENCODERS
+    template <uint8_t N>
+    static void IRAM_ATTR encoderChanged()
+    {
+        AsyncButton::Encoder &encoder = watching->encoders[N];
+        turn(encoder, readPhase(encoder));
+    }
+
+    static void (*const encoderHandlers[8])() = {
+        encoderChanged<0>, encoderChanged<1>, encoderChanged<2>, encoderChanged<3>,
+        encoderChanged<4>, encoderChanged<5>, encoderChanged<6>, encoderChanged<7>};
+
+#ifdef ABUTTON_PCINT
+    static volatile uint8_t pcintEncoders[ABUTTON_PCINT]; // Encoders served by each pin change interrupt bank
+
+    static void pcintTurned(uint8_t mask)
+    {
+        for (uint8_t e = 0; mask; ++e, mask >>= 1)
+            if (mask & 1)
+                turn(watching->encoders[e], readPhase(watching->encoders[e]));
+    }
+#endif
+
+    static bool watchable(uint8_t pin)
+    {
+        if (digitalPinToInterrupt(pin) != NOT_AN_INTERRUPT)
+            return true;
+#ifdef ABUTTON_PCINT
+        return digitalPinToPCICR(pin) && digitalPinToPCICRbit(pin) < ABUTTON_PCINT;
+#else
+        return false;
+#endif
+    }
+
+    // Decode the encoder from pin change interrupts on both of its pins when they have them
+    static void watchEncoder(AsyncButton::Config &conf, uint8_t e)
+    {
+        auto &encoder = conf.encoders[e];
+        if (e >= 8 || !watchable(encoder.pinA) || !watchable(encoder.pinB))
+            return;
+        const uint8_t pins[2] = {encoder.pinA, encoder.pinB};
+        for (uint8_t pin : pins)
+        {
+            int irq = digitalPinToInterrupt(pin);
+            if (irq != NOT_AN_INTERRUPT)
+                attachInterrupt(irq, encoderHandlers[e], CHANGE);
+#ifdef ABUTTON_PCINT
+            else
+            {
+                volatile uint8_t *pcicr = digitalPinToPCICR(pin);
+                uint8_t bank = digitalPinToPCICRbit(pin);
+                pcintEncoders[bank] |= 1 << e;
+                *digitalPinToPCMSK(pin) |= _BV(digitalPinToPCMSKbit(pin));
+                *pcicr |= _BV(bank);
+            }
+#endif
+        }
+        encoder.watched = true;
+    }
+#endif
+#endif
+
+    // Returns false when another Config already owns the interrupts or the timer, this one then scans its buttons
+    static bool init(AsyncButton::Config &conf, void (*callback)(), uint8_t flags)
+    {
+        conf.callback = callback;
+        bool owner = true;
+#if defined(BUTTON_PROFILE) && defined(BUTTON_PROFILE_PIN)
+        pinMode(BUTTON_PROFILE_PIN, OUTPUT);
+        digitalWrite(BUTTON_PROFILE_PIN, LOW);
+#endif
+        buildIndex(conf);
+        buildGraph(conf);
+        conf.cursor = 0;
+#ifdef BUTTON_PORT_READ
+        conf.portCount = 0;
+#endif
+#ifdef ABUTTON_EDGES
+        conf.edgeTail = conf.edgeHead; // Edges queued before this setup are stale
+#endif
+#ifdef BUTTON_INTERRUPT
+        conf.watched = conf.size < 32 ? ~(((uint32_t)1 << conf.size) - 1) : 0; // Missing buttons never change
+        conf.active = 0;
+        bool interrupts = !watching || watching == &conf; // Only one Config can own the interrupts
+        owner = owner && interrupts;
+        if (interrupts)
+        {
+            watching = &conf;
+#ifdef ABUTTON_PCINT
+            memset((void *)pcintButtons, 0, sizeof(pcintButtons));
+#if defined(BUTTON_ENCODERS)
+            memset((void *)pcintEncoders, 0, sizeof(pcintEncoders));
+#endif
+#endif
+        }
+#endif
+#ifdef BUTTON_TIMER
+        bool timer = !ticking || ticking == &conf; // Only one Config can be sampled by tick()
+        owner = owner && timer;
+        if (timer)
+            ticking = nullptr; // Pause sampling while the buttons are set up
+#endif
+#ifndef BUTTON_SERIAL_DISABLE
+        if (!(flags & BUT_SILENT))
+        {
+            if (!owner)
+                SERIAL.println(F(ABUTTON_LOG_PREFIX "Error: interrupts or timer owned by another configuration, scanning instead"));
+            SERIAL.print(F(ABUTTON_LOG_PREFIX "Setup long: " ANSI_YELLOW));
+            SERIAL.print(timingOf(conf).longPress);
+            SERIAL.print(F(ANSI_DEFAULT " double: " ANSI_YELLOW));
+            SERIAL.print(timingOf(conf).doubleClick);
+            SERIAL.print(F(ANSI_DEFAULT " debounce: " ANSI_YELLOW));
+            SERIAL.print(timingOf(conf).debounce);
+            SERIAL.println(F(ANSI_DEFAULT "ms"));
+        }
+#endif
+        for (Source *source = conf.sources; source; source = source->next)
+        {
+            source->begin();
+#ifndef BUTTON_SERIAL_DISABLE
+            if (!(flags & BUT_SILENT))
+            {
+                SERIAL.print(F(ABUTTON_LOG_PREFIX "Init source on pins: " ANSI_YELLOW));
+                SERIAL.print(source->base);
+                SERIAL.print(F(ANSI_DEFAULT "-" ANSI_YELLOW));
+                SERIAL.print(source->base + source->count - 1);
+                SERIAL.println(F(ANSI_DEFAULT));
+            }
+#endif
+        }
+        for (size_t i = 0; i < conf.size; ++i)
+        {
+#ifdef BUTTON_INTERRUPT
+            if (conf.buttons[i].pin == 255 && i < 32)
+                conf.watched |= (uint32_t)1 << i; // Disabled buttons never change
+#endif
+            if (conf.buttons[i].pin != 255 && !sourceOf(conf, conf.buttons[i].pin))
+            {
+                pinMode(conf.buttons[i].pin, INPUT_PULLUP);
+#ifdef BUTTON_PORT_READ
+                conf.buttons[i].port = portSlot(conf, conf.buttons[i].pin, conf.buttons[i].mask);
+#endif
+#ifdef BUTTON_INTERRUPT
+                if (interrupts)
+                    watch(conf, i);
+#endif
+#ifndef BUTTON_SERIAL_DISABLE
+                if (!(flags & BUT_SILENT))
+                {
+                    SERIAL.print(F(ABUTTON_LOG_PREFIX "Init button on pin: " ANSI_YELLOW));
+                    SERIAL.print(conf.buttons[i].pin);
+                    SERIAL.println(F(ANSI_DEFAULT));
+                }
+#endif
+            }
+        }
+#ifdef BUTTON_ENCODERS
+        for (uint8_t e = 0; e < conf.encoderCount; ++e)
+        {
+            auto &encoder = conf.encoders[e];
+            bool physical = !sourceOf(conf, encoder.pinA) && !sourceOf(conf, encoder.pinB);
+            if (!sourceOf(conf, encoder.pinA))
+                pinMode(encoder.pinA, INPUT_PULLUP);
+            if (!sourceOf(conf, encoder.pinB))
+                pinMode(encoder.pinB, INPUT_PULLUP);
+#ifdef BUTTON_PORT_READ
+            encoder.portA = physical ? portSlot(conf, encoder.pinA, encoder.maskA) : 0;
+            encoder.portB = physical ? portSlot(conf, encoder.pinB, encoder.maskB) : 0;
+#endif
+            encoder.phase = phaseOf(conf, encoder, nullptr);
+            encoder.sub = 0;
+            encoder.pending = 0;
+            encoder.delta = 0;
+            encoder.watched = false;
+#ifdef BUTTON_INTERRUPT
+            if (interrupts && physical)
+                watchEncoder(conf, e);
+#endif
+#ifdef BUTTON_TIMER
+            encoder.watched = timer && physical; // Decoded by tick()
+#endif
+            (void)physical;
+        }
+#endif
+#ifdef BUTTON_TIMER
+        if (timer)
+        {
+            memset(conf.lanes, 0, sizeof(conf.lanes));
+#ifdef ABUTTON_TIMER2
+            static_assert(F_CPU / 64000UL * BUTTON_TIMER_PERIOD <= 256, "AsyncButton: BUTTON_TIMER_PERIOD too long for Timer2, call tick() from your own timer");
+            uint8_t sreg = SREG;
+            cli();
+            TCCR2A = _BV(WGM21); // CTC mode
+            TCCR2B = _BV(CS22);  // clk/64
+            OCR2A = F_CPU / 64000UL * BUTTON_TIMER_PERIOD - 1;
+            TIMSK2 |= _BV(OCIE2A);
+            SREG = sreg;
+#endif
+            ticking = &conf;
+        }
+#endif
+        return owner;
+    }
+
+#ifndef BUTTON_NO_DEFAULT_CONFIG
+    bool setup(void (*callback)(), uint8_t flags)
+    {
+        return setup(ButtonConfig, callback, flags);
+    }
+#endif
+
+    bool setup(AsyncButton::Config &conf, void (*callback)(), uint8_t flags)
+    {
+        Current = &conf;
+        return init(conf, callback, flags);
+    }
+
+    static void edge(AsyncButton::Config &conf, AsyncButton::State &button, uint8_t reading, AsyncButton::Time now, const AsyncButton::Timing &timing)
+    {
+        if (reading == button.state)
+            return;
+        if (reading == PRESSED)
+        {
+#ifdef BUTTON_IMMEDIATE
+            button.reported = 0;
+#endif
+#ifdef BUTTON_COMPACT_STATE
+            if (!button.stale && elapsed(now, button.last_time) < timing.doubleClick)
+#else
+            if (button.last_time && elapsed(now, button.last_time) < timing.doubleClick) // 0 = no earlier press
+#endif
+                button.doublePress = true;
+            else
+                button.doublePress = false;
+            button.duration = 0;
+            button.last_time = now;
+            button.lastLongPressCallback = now;
+#if defined(BUTTON_READERS) && defined(BUTTON_IMMEDIATE)
+            if (timing.flags & BUT_IMMEDIATE)
+                button.generation++; // Reported from the press edge on
+#endif
+#ifdef BUTTON_COMPACT_STATE
+            button.stale = false;
+#endif
+#ifdef BUTTON_INTERRUPT
+            size_t i = &button - conf.buttons;
+            if (i < 32)
+                conf.active |= (uint32_t)1 << i; // A press through the mapping graph raises no interrupt of its own
+#endif
+        }
+        else if (reading == RELEASED && button.state == PRESSED)
+        {
+            if (heldByMapper(conf, button))
+                return; // Stays pressed while a button mapped to it is held
+#ifdef BUTTON_STATS
+            record(conf, button, elapsed(now, button.last_time), timing);
+#endif
+#ifdef BUTTON_CHORDS
+            uint32_t bit = chordBit(conf, button);
+            if (conf.swallowed & bit)
+            {
+                // The press went to a chord, release without reporting it
+#ifdef BUTTON_RECORD
+                capture(conf, button, reading, now);
+#endif
+                forget(conf, button);
+                button.state = RELEASED;
+                button.duration = 0;
+#ifdef BUTTON_IMMEDIATE
+                button.reported = BUT_SHORT | BUT_LONG | BUT_DOUBLE;
+#endif
+#ifdef BUTTON_COMPACT_STATE
+                button.stale = true;
+#else
+                button.last_time = 0;
+#endif
+                return;
+            }
+#endif
+            button.duration = elapsed(now, button.last_time);
+#ifdef BUTTON_READERS
+#ifdef BUTTON_IMMEDIATE
+            if (!(timing.flags & BUT_IMMEDIATE))
+#endif
+                button.generation++;
+#endif
+        }
+#ifdef BUTTON_RECORD
+        capture(conf, button, reading, now);
+#endif
+        button.state = reading;
+#ifdef BUTTON_REPEAT
+        if (reading == PRESSED && conf.repeatCount)
+            arm(conf, button, now);
+#endif
+#ifdef BUTTON_GESTURES
+        if (reading == RELEASED && conf.sequenceCount)
+            advance(conf, button, now, timing);
+#endif
+#ifdef BUTTON_CHORDS
+        if (reading == PRESSED)
+            conf.pressed |= chordBit(conf, button);
+        else
+            conf.pressed &= ~chordBit(conf, button);
+#endif
+#ifdef ABUTTON_EVENTS
+        // Copy the fields first, handlers may reset the button
+        uint8_t pin = button.pin;
+        Time duration = button.duration;
+        bool doublePress = button.doublePress;
+        if (reading == PRESSED)
+            emit(conf, BUTTON_EVENT_PRESS, pin, now, 0);
+        else
+        {
+            emit(conf, BUTTON_EVENT_RELEASE, pin, now, duration);
+            emit(conf, duration > timing.longPress ? BUTTON_EVENT_LONG : BUTTON_EVENT_SHORT, pin, now, duration);
+            if (doublePress)
+                emit(conf, BUTTON_EVENT_DOUBLE, pin, now, duration);
+        }
+#endif
+        if (reading != PRESSED)
+            return;
+        // Press the buttons this one maps to, they release on their own once no mapper is held
+        if (button.mappedIndex != 255)
+        {
+            auto &target = conf.buttons[button.mappedIndex];
+            edge(conf, target, PRESSED, now, timingOf(target, timingOf(conf)));
+        }
+#if BUTTON_MAX_MAPPINGS > 0
+        for (uint8_t l = button.firstLink; l != 255; l = conf.mappings[l].nextOut)
+        {
+            auto &target = conf.buttons[conf.mappings[l].to];
+            edge(conf, target, PRESSED, now, timingOf(target, timingOf(conf)));
+        }
+#endif
+    }
+
+    static void hold(AsyncButton::Config &conf, AsyncButton::State &button, uint8_t reading, AsyncButton::Time now, const AsyncButton::Timing &timing)
+    {
+        if (reading == PRESSED &&
+            button.state == PRESSED &&
+#ifdef BUTTON_CHORDS
+            !(conf.swallowed & chordBit(conf, button)) &&
+#endif
+#ifndef ABUTTON_EVENTS
+            conf.callback &&
+#endif
+            elapsed(now, button.last_time) >= timing.longPress &&
+            elapsed(now, button.lastLongPressCallback) >= timing.longPress)
+        {
+            button.lastLongPressCallback = now;
+            if (conf.callback)
+                conf.callback();
+#ifdef ABUTTON_EVENTS
+            emit(conf, BUTTON_EVENT_HOLD, button.pin, now, elapsed(now, button.last_time));
+#endif
+        }
+        if (reading == RELEASED)
+        {
+            button.lastLongPressCallback = 0;
+#ifdef BUTTON_COMPACT_STATE
+            // Flag old presses before the 16-bit timestamps wrap around
+            if (!button.stale && elapsed(now, button.last_time) > timing.doubleClick)
+                button.stale = true;
+#endif
+        }
+    }
+
+    // Time from now until the button next needs an update(), from its own timestamps
+    static inline AsyncButton::Time deadlineOf(const AsyncButton::Config &conf, const AsyncButton::State &button, AsyncButton::Time now, const AsyncButton::Timing &timing)
+    {
+        Time wait = BUTTON_NO_DEADLINE;
+        if (button.state == RELEASED && button.lastReading == RELEASED && !button.duration)
+            return wait; // Idle
+        if (button.lastReading != button.state && elapsed(now, button.lastChangeTime) <= timing.debounce)
+            wait = timing.debounce + 1 - elapsed(now, button.lastChangeTime); // Debounce settles
+        if (button.state == PRESSED)
+        {
+#ifdef BUTTON_CHORDS
+            if (conf.swallowed & chordBit(conf, button))
+                return wait;
+#endif
+#ifndef ABUTTON_EVENTS
+            if (!conf.callback)
+                return wait;
+#else
+            (void)conf;
+#endif
+            // Next long press callback
+            Time held = elapsed(now, button.last_time), repeated = elapsed(now, button.lastLongPressCallback);
+            Time since = held < repeated ? held : repeated;
+            Time hold = since < timing.longPress ? timing.longPress - since : 0;
+            return hold < wait ? hold : wait;
+        }
+#ifdef BUTTON_COMPACT_STATE
+        if (button.duration && !button.stale && elapsed(now, button.last_time) <= timing.doubleClick)
+#else
+        if (button.duration && elapsed(now, button.last_time) <= timing.doubleClick)
+#endif
+        {
+            // Double click window closes and the press is reported
+            Time expiry = timing.doubleClick + 1 - elapsed(now, button.last_time);
+            if (expiry < wait)
+                wait = expiry;
+        }
+        return wait;
+    }
+
+    // Debounce one reading and record when the button next needs an update()
+    AsyncButton::Time step(AsyncButton::Config &conf, AsyncButton::State &button, uint8_t reading, AsyncButton::Time now, const AsyncButton::Timing &timing)
+    {
+        if (reading != button.lastReading)
+        {
+#ifdef BUTTON_STATS
+            if (reading == button.state && elapsed(now, button.lastChangeTime) <= timing.debounce)
+                bounced(conf, &button - conf.buttons); // Back at the debounced level before the change was accepted
+#endif
+            button.lastChangeTime = now;
+        }
+        if (elapsed(now, button.lastChangeTime) > timing.debounce)
+            edge(conf, button, reading, now, timing);
+        button.lastReading = reading;
+        hold(conf, button, reading, now, timing);
+        Time wait = deadlineOf(conf, button, now, timing);
+        due(conf, wait);
+        return wait;
+    }
+
+#ifdef BUTTON_VERTICAL_DEBOUNCE
+    // Raw readings of the buttons of a lane, one bit each (1 = PRESSED)
+    static inline VerticalWord sampleLane(const AsyncButton::Config &conf, size_t base, size_t end, const void *sample)
+    {
+        VerticalWord raw = 0;
+        for (size_t i = base; i < end; ++i)
+            if (conf.buttons[i].pin != 255 && readPin(conf, conf.buttons[i], sample) == PRESSED)
+                raw |= (VerticalWord)1 << (i - base);
+        return raw;
+    }
+
+    // Two-bit vertical counter: a bit toggles after four consecutive samples disagree with it, returns the toggled bits
+    static inline VerticalWord clockLane(AsyncButton::Lane &lane, VerticalWord raw)
+    {
+        VerticalWord delta = raw ^ lane.state;
+        lane.cnt1 = (lane.cnt1 ^ lane.cnt0) & delta;
+        lane.cnt0 = ~lane.cnt0 & delta;
+        VerticalWord toggled = delta & ~(lane.cnt0 | lane.cnt1);
+        lane.state ^= toggled;
+        return toggled;
+    }
+
+#ifdef BUTTON_STATS
+    // Sample a lane on every update() or tick(), not only on counter ticks, and count a bounce for each reading
+    // that went back to the debounced level: the rule of step(), applied to the same readings
+    static inline VerticalWord sampleCounted(const AsyncButton::Config &conf, AsyncButton::Lane &lane, size_t base, size_t end, const void *sample)
+    {
+        VerticalWord raw = sampleLane(conf, base, end, sample);
+        size_t b = base;
+        for (VerticalWord back = (raw ^ lane.raw) & ~(raw ^ lane.state); back; ++b, back >>= 1)
+            if (back & 1)
+                bounced(conf, b);
+        lane.raw = raw;
+        return raw;
+    }
+#endif
+
+    static inline size_t laneCount(const AsyncButton::Config &conf)
+    {
+        return conf.size < BUTTON_VERTICAL_LANES * BUTTON_VERTICAL_WIDTH ? conf.size : BUTTON_VERTICAL_LANES * BUTTON_VERTICAL_WIDTH;
+    }
+
+    static size_t verticalUpdate(AsyncButton::Config &conf, AsyncButton::Time now, const void *sample)
+    {
+        const Timing &shared = timingOf(conf);
+        size_t count = laneCount(conf);
+        bool tick = elapsed(now, conf.lastTick) >= BUTTON_VERTICAL_TICK;
+        if (tick)
+            conf.lastTick = now;
+        for (size_t base = 0, l = 0; base < count; base += BUTTON_VERTICAL_WIDTH, ++l)
+        {
+            auto &lane = conf.lanes[l];
+            size_t end = base + BUTTON_VERTICAL_WIDTH < count ? base + BUTTON_VERTICAL_WIDTH : count;
+#ifdef BUTTON_STATS
+            VerticalWord raw = sampleCounted(conf, lane, base, end, sample);
+#endif
+            if (tick)
+            {
+#ifdef BUTTON_STATS
+                clockLane(lane, raw);
+#else
+                clockLane(lane, sampleLane(conf, base, end, sample));
+#endif
+#ifdef BUTTON_INTERRUPT
+                VerticalWord busy = lane.state | lane.cnt0 | lane.cnt1; // Buttons needing further updates
+#endif
+                for (size_t i = base; i < end; ++i)
+                {
+                    auto &button = conf.buttons[i];
+                    uint8_t reading = (lane.state >> (i - base)) & 1 ? PRESSED : RELEASED;
+                    if (reading != button.state)
+                    {
+                        button.lastReading = reading;
+                        edge(conf, button, reading, now, timingOf(button, shared));
+                        hold(conf, button, reading, now, timingOf(button, shared));
+                        if (reading == RELEASED)
+                            lane.open |= (VerticalWord)1 << (i - base);
+                    }
+#ifdef BUTTON_COMPACT_STATE
+                    else if (reading == RELEASED)
+                        hold(conf, button, reading, now, timingOf(button, shared));
+#ifdef BUTTON_INTERRUPT
+                    if (!button.stale)
+                        busy |= (VerticalWord)1 << (i - base);
+#endif
+#endif
+#ifdef BUTTON_INTERRUPT
+                    if (button.state == PRESSED)
+                        busy |= (VerticalWord)1 << (i - base); // Held by a mapping button, retry the release
+#endif
+                }
+#ifdef BUTTON_INTERRUPT
+                busy |= lane.open;
+                if (base < 32)
+                {
+                    uint32_t laneBits = (uint32_t)(VerticalWord)~0 << base;
+                    conf.active = (conf.active & ~laneBits) | ((uint32_t)busy << base);
+                }
+#endif
+            }
+            if (lane.cnt0 | lane.cnt1)
+                due(conf, BUTTON_VERTICAL_TICK - elapsed(now, conf.lastTick)); // Counters still running
+            // Only pressed buttons and those with a deadline ahead need further work between ticks
+            size_t i = base;
+            for (VerticalWord pending = lane.state | lane.open; pending; ++i, pending >>= 1)
+            {
+                if (!(pending & 1))
+                    continue;
+                auto &button = conf.buttons[i];
+                const Timing &timing = timingOf(button, shared);
+                VerticalWord bit = (VerticalWord)1 << (i - base);
+                if (lane.state & bit)
+                    hold(conf, button, PRESSED, now, timing);
+                Time wait = deadlineOf(conf, button, now, timing);
+                due(conf, wait);
+                if (wait == BUTTON_NO_DEADLINE && !(lane.state & bit))
+                    lane.open &= ~bit;
+            }
+        }
+        return count;
+    }
+#endif
+
+#ifdef ABUTTON_EDGES
+    // Replay the edges queued by the sampling path in their order and at their own times
+    static void drainEdges(AsyncButton::Config &conf)
+    {
+        const Timing &shared = timingOf(conf);
+#ifdef BUTTON_SNAPSHOT
+        Time epoch = conf.epoch; // Edges are stamped on the clock of the sampling path, moved onto the clock of timeOf()
+#else
+        Time epoch = 0;
+#endif
+        for (uint8_t tail = conf.edgeTail; tail != loadAcquire(conf.edgeHead); tail = conf.edgeTail)
+        {
+            Edge queued = conf.edges[tail];
+            storeRelease(conf.edgeTail, (tail + 1) & (BUTTON_EVENT_QUEUE_SIZE - 1));
+            if (queued.index >= conf.size)
+                continue;
+            auto &button = conf.buttons[queued.index];
+            edge(conf, button, queued.level, queued.time + epoch, timingOf(button, shared));
+            button.lastReading = queued.level;
+        }
+    }
+#endif
+
+#ifdef BUTTON_TIMER
+#define ABUTTON_TIMER_DIVIDER (BUTTON_VERTICAL_TICK / BUTTON_TIMER_PERIOD ? BUTTON_VERTICAL_TICK / BUTTON_TIMER_PERIOD : 1)
+
+    // Count the tick and clock the vertical counters of the ticking Config
+    static void IRAM_ATTR clockLanes()
+    {
+        static uint8_t divider = 0;
+        ticks += BUTTON_TIMER_PERIOD;
+        if (!ticking)
+            return;
+#ifdef BUTTON_ENCODERS
+        for (uint8_t e = 0; e < ticking->encoderCount; ++e)
+            if (ticking->encoders[e].watched)
+                turn(ticking->encoders[e], readPhase(ticking->encoders[e])); // Every tick, quadrature moves faster than bounce
+#endif
+        bool clock = ++divider >= ABUTTON_TIMER_DIVIDER;
+#ifndef BUTTON_STATS
+        if (!clock)
+            return; // The bounce counters need the readings of every tick, the debounce only those of a counter tick
+#endif
+        if (clock)
+            divider = 0;
+        AsyncButton::Config &conf = *ticking;
+#ifdef BUTTON_PORT_READ
+        PortWord sample[BUTTON_MAX_PORTS];
+        for (uint8_t p = 0; p < conf.portCount; ++p)
+            sample[p] = *conf.ports[p];
+#else
+        const void *sample = nullptr;
+#endif
+        size_t count = laneCount(conf);
+        for (size_t base = 0, l = 0; base < count; base += BUTTON_VERTICAL_WIDTH, ++l)
+        {
+            auto &lane = conf.lanes[l];
+            size_t end = base + BUTTON_VERTICAL_WIDTH < count ? base + BUTTON_VERTICAL_WIDTH : count;
+#ifdef BUTTON_STATS
+            VerticalWord raw = sampleCounted(conf, lane, base, end, sample);
+            if (!clock)
+                continue;
+#else
+            VerticalWord raw = sampleLane(conf, base, end, sample);
+#endif
+            VerticalWord toggled = clockLane(lane, raw);
+#ifdef ABUTTON_EDGES
+            for (VerticalWord bits = toggled, b = 0; bits; ++b, bits >>= 1)
+                if ((bits & 1) && pushEdge(conf, base + b, lane.state >> b & 1 ? PRESSED : RELEASED, ticks))
+                    toggled &= ~((VerticalWord)1 << b); // Queued, latched below only when the queue is full
+#endif
+            lane.pressed |= toggled & lane.state;
+            lane.released |= toggled & ~lane.state;
+            for (uint8_t b = 0; toggled; ++b, toggled >>= 1)
+                if (toggled & 1)
+                    (lane.state >> b & 1 ? lane.pressTime : lane.releaseTime)[b] = ticks;
+        }
+    }
+
+    void IRAM_ATTR tick()
+    {
+#if defined(ARDUINO_ARCH_ESP32)
+        portENTER_CRITICAL_ISR(&tickLock);
+        clockLanes();
+        portEXIT_CRITICAL_ISR(&tickLock);
+#else
+        clockLanes();
+#endif
+    }
+
+    // Turn the edges latched by tick() into button transitions, using the latched edge times
+    static size_t timerUpdate(AsyncButton::Config &conf, AsyncButton::Time now)
+    {
+#ifdef ABUTTON_EDGES
+        drainEdges(conf); // Before the lanes are read, so their state is never older than the edges
+#endif
+        const Timing &shared = timingOf(conf);
+        size_t count = laneCount(conf);
+        for (size_t base = 0, l = 0; base < count; base += BUTTON_VERTICAL_WIDTH, ++l)
+        {
+            auto &lane = conf.lanes[l];
+            size_t end = base + BUTTON_VERTICAL_WIDTH < count ? base + BUTTON_VERTICAL_WIDTH : count;
+            VerticalWord state, pressed, released;
+            Time pressTime[BUTTON_VERTICAL_WIDTH], releaseTime[BUTTON_VERTICAL_WIDTH];
+            uint8_t saved = lock();
+            state = lane.state;
+            pressed = lane.pressed;
+            released = lane.released;
+            for (VerticalWord edges = pressed | released, b = 0; edges; ++b, edges >>= 1)
+                if (edges & 1)
+                {
+                    pressTime[b] = lane.pressTime[b];
+                    releaseTime[b] = lane.releaseTime[b];
+                }
+            lane.pressed = lane.released = 0;
+            unlock(saved);
+            for (size_t i = base; i < end; ++i)
+            {
+                auto &button = conf.buttons[i];
+                const Timing &timing = timingOf(button, shared);
+                size_t b = i - base;
+                VerticalWord bit = (VerticalWord)1 << b;
+                uint8_t reading = state & bit ? PRESSED : RELEASED;
+#ifdef BUTTON_SNAPSHOT
+                Time epoch = conf.epoch; // Edges are latched on the tick counter, moved onto the clock of timeOf()
+#else
+                Time epoch = 0;
+#endif
+                if (reading == button.state && (pressed & bit) && (released & bit))
+                {
+                    // Pressed and released again between two updates
+                    uint8_t missed = reading == PRESSED ? RELEASED : PRESSED;
+                    edge(conf, button, missed, (missed == PRESSED ? pressTime[b] : releaseTime[b]) + epoch, timing);
+                }
+                if (reading != button.state)
+                {
+                    VerticalWord latched = reading == PRESSED ? pressed : released;
+                    Time time = reading == PRESSED ? pressTime[b] : releaseTime[b];
+                    edge(conf, button, reading, latched & bit ? (Time)(time + epoch) : now, timing); // No edge latched: taken over from another engine
+                }
+                button.lastReading = reading;
+                hold(conf, button, reading, now, timing);
+                due(conf, deadlineOf(conf, button, now, timing));
+            }
+            if (lane.cnt0 | lane.cnt1)
+                due(conf, BUTTON_VERTICAL_TICK); // Counters still running in tick()
+        }
+        return count;
+    }
+#endif
+
+    struct Pass
+    {
+        Time now;              // Time of this update
+        const Timing *shared;  // Timing of buttons without a profile
+        size_t first;          // First button not handled by the vertical counters
+#ifdef BUTTON_PORT_READ
+        PortWord sample[BUTTON_MAX_PORTS]; // Port registers read at the start of the update
+#endif
+#ifdef BUTTON_INTERRUPT
+        uint32_t dirty; // Buttons whose pin changed since the last update
+        uint32_t work;  // Buttons to process
+#endif
+    };
+
+    // Sample everything shared by the buttons of one update, false when there is nothing to do
+    static bool begin(AsyncButton::Config &conf, Pass &pass)
+    {
+        pass.now = conf.now = timeOf(conf);
+        pass.shared = &timingOf(conf);
+        conf.deadline = BUTTON_NO_DEADLINE;
+        for (Source *source = conf.sources; source; source = source->next)
+            source->scan();
+#ifdef BUTTON_RECORD
+        if (conf.tape && conf.tape->replaying)
+        {
+#ifdef BUTTON_INTERRUPT
+            conf.active |= replay(conf, pass.now);
+#else
+            replay(conf, pass.now);
+#endif
+        }
+#endif
+#ifdef BUTTON_INTERRUPT
+        pass.dirty = &conf == watching ? takeDirty() : 0;
+        conf.active |= pass.dirty;
+#ifdef ABUTTON_EDGES
+        if (&conf == watching)
+            drainEdges(conf); // After the dirty bits, which the interrupts set after queueing
+#endif
+        pass.work = conf.active | ~conf.watched;
+        if (!pass.work && conf.size <= 32)
+        {
+#ifdef BUTTON_ENCODERS
+            encoders(conf, nullptr, pass.now);
+#endif
+#ifdef BUTTON_GESTURES
+            gestures(conf, pass.now);
+#endif
+            return false; // Nothing changed and nothing is pressed or debouncing
+        }
+#endif
+#ifdef BUTTON_PORT_READ
+        for (uint8_t p = 0; p < conf.portCount; ++p)
+            pass.sample[p] = *conf.ports[p];
+        const void *sample = pass.sample;
+#else
+        const void *sample = nullptr;
+#endif
+#ifdef BUTTON_ENCODERS
+        encoders(conf, sample, pass.now);
+#endif
+#ifdef BUTTON_TIMER
+        if (&conf == ticking)
+            pass.first = timerUpdate(conf, pass.now);
+        else
+#endif
+#ifdef BUTTON_VERTICAL_DEBOUNCE
+        pass.first = verticalUpdate(conf, pass.now, sample);
+#else
+        (void)sample;
+        pass.first = 0;
+#endif
+        return true;
+    }
+
+    static void process(AsyncButton::Config &conf, const Pass &pass, size_t i)
+    {
+        auto &button = conf.buttons[i];
+#ifdef BUTTON_INTERRUPT
+        uint32_t bit = i < 32 ? (uint32_t)1 << i : 0;
+        if (bit && !(pass.work & bit))
+            return;
+#endif
+        if (button.pin == 255)
+            return;
+#ifdef BUTTON_PORT_READ
+        uint8_t reading = readPin(conf, button, pass.sample);
+#else
+        uint8_t reading = readPin(conf, button, nullptr);
+#endif
+#ifdef BUTTON_INTERRUPT
+        if (reading != button.lastReading && (pass.dirty & bit))
+        {
+#ifdef BUTTON_SNAPSHOT
+            Time changed = changeTime(i, pass.now - conf.epoch) + conf.epoch;
+#else
+            Time changed = changeTime(i, pass.now);
+#endif
+#ifdef BUTTON_STATS
+            if (reading == button.state && elapsed(changed, button.lastChangeTime) <= timingOf(button, *pass.shared).debounce)
+                bounced(conf, i);
+#endif
+            button.lastChangeTime = changed; // Debounce from the latched interrupt time
+            button.lastReading = reading;
+        }
+#endif
+        const Timing &timing = timingOf(button, *pass.shared);
+#ifdef BUTTON_INTERRUPT
+        Time wait = step(conf, button, reading, pass.now, timing);
+#ifdef BUTTON_COMPACT_STATE
+        if (button.state == PRESSED || reading != button.state || wait != BUTTON_NO_DEADLINE || !button.stale)
+#else
+        if (button.state == PRESSED || reading != button.state || wait != BUTTON_NO_DEADLINE)
+#endif
+            conf.active |= bit;
+        else
+            conf.active &= ~bit;
+#else
+        step(conf, button, reading, pass.now, timing);
+#endif
+    }
+
+    void update(AsyncButton::Config &conf)
+    {
+        ABUTTON_PROBE_MARK(update);
+        Pass pass;
+        if (!begin(conf, pass))
+            return;
+        for (size_t i = pass.first; i < conf.size; ++i)
+            process(conf, pass, i);
+#ifdef BUTTON_CHORDS
+        chords(conf, pass.now);
+#endif
+#ifdef BUTTON_REPEAT
+        repeats(conf, pass.now);
+#endif
+#ifdef BUTTON_GESTURES
+        gestures(conf, pass.now);
+#endif
+    }
+
+    static void update(AsyncButton::Config &conf, unsigned long budget)
+    {
+        ABUTTON_PROBE_MARK(update);
+        unsigned long start = micros();
+        Pass pass;
+        if (!begin(conf, pass))
+            return;
+        // Resume at the cursor, at least one button per call and never more than one round
+        for (size_t n = pass.first; n < conf.size; ++n)
+        {
+            if (conf.cursor < pass.first || conf.cursor >= conf.size)
+                conf.cursor = pass.first;
+            size_t i = conf.cursor++;
+            process(conf, pass, i);
+            if ((unsigned long)(micros() - start) >= budget)
+            {
+                if (n + 1 < conf.size)
+                    due(conf, 0); // The rest of the round is left for the next call
+                break;
+            }
+        }
+#ifdef BUTTON_CHORDS
+        chords(conf, pass.now);
+#endif
+#ifdef BUTTON_REPEAT
+        repeats(conf, pass.now);
+#endif
+#ifdef BUTTON_GESTURES
+        gestures(conf, pass.now);
+#endif
+    }
+
+    void update()
+    {
+        update(*Current);
+    }
+
+    void update(unsigned long budget)
+    {
+        update(*Current, budget);
+    }
+
+    // Nothing pressed, debouncing, inside a double click window or waiting in the queue
+    static bool isIdle(const AsyncButton::Config &conf)
+    {
+        ABUTTON_GUARD;
+#ifdef BUTTON_INTERRUPT
+        if (&conf == watching && dirtyMask)
+            return false;
+#endif
+#ifdef BUTTON_EVENT_QUEUE
+        if (conf.head != conf.tail)
+            return false;
+#endif
+#ifdef ABUTTON_EDGES
+        if (conf.edgeHead != conf.edgeTail)
+            return false; // Edges not replayed yet
+#endif
+#ifdef BUTTON_ENCODERS
+        for (uint8_t e = 0; e < conf.encoderCount; ++e)
+            if (conf.encoders[e].pending || conf.encoders[e].sub)
+                return false;
+#endif
+#ifdef BUTTON_GESTURES
+        if (conf.sequencing)
+            return false;
+#endif
+#ifdef BUTTON_RECORD
+        if (conf.tape && conf.tape->replaying)
+            return false;
+#endif
+#ifdef BUTTON_VERTICAL_DEBOUNCE
+        for (size_t l = 0; l < BUTTON_VERTICAL_LANES; ++l)
+        {
+            const auto &lane = conf.lanes[l];
+#ifdef BUTTON_TIMER
+            if (lane.pressed | lane.released)
+                return false;
+#endif
+            if (lane.state | lane.cnt0 | lane.cnt1)
+                return false;
+        }
+#endif
+        const Timing &shared = timingOf(conf);
+        for (size_t i = 0; i < conf.size; ++i)
+        {
+            const auto &button = conf.buttons[i];
+            if (button.state == PRESSED || (button.pin != 255 && button.lastReading != RELEASED))
+                return false;
+#ifdef BUTTON_COMPACT_STATE
+            if (button.duration && !button.stale && elapsed(conf.now, button.last_time) <= timingOf(button, shared).doubleClick)
+#else
+            if (button.duration && elapsed(conf.now, button.last_time) <= timingOf(button, shared).doubleClick)
+#endif
+                return false;
+        }
+        return true;
+    }
+
+    bool isIdle()
+    {
+        return isIdle(*Current);
+    }
+
+    // Deadline of the last update(), counted down to the present, due at once after a latched edge
+    static AsyncButton::Time nextDeadline(const AsyncButton::Config &conf)
+    {
+        ABUTTON_GUARD;
+#ifdef BUTTON_INTERRUPT
+        if (&conf == watching && dirtyMask)
+            return 0;
+#endif
+#ifdef ABUTTON_EDGES
+        if (conf.edgeTail != loadAcquire(conf.edgeHead))
+            return 0; // Edges queued by the interrupts or tick()
+#endif
+#ifdef BUTTON_ENCODERS
+        for (uint8_t e = 0; e < conf.encoderCount; ++e)
+            if (conf.encoders[e].pending)
+                return 0; // Detents decoded by the interrupts or tick()
+#endif
+#ifdef BUTTON_TIMER
+        if (&conf == ticking)
+        {
+            VerticalWord latched = 0;
+            uint8_t saved = lock();
+            for (size_t l = 0; l < BUTTON_VERTICAL_LANES; ++l)
+                latched |= conf.lanes[l].pressed | conf.lanes[l].released;
+            unlock(saved);
+            if (latched)
+                return 0;
+        }
+#endif
+        if (conf.deadline == BUTTON_NO_DEADLINE)
+            return BUTTON_NO_DEADLINE;
+        Time passed = elapsed(timeOf(conf), conf.now);
+        return passed < conf.deadline ? conf.deadline - passed : 0;
+    }
+
+    AsyncButton::Time nextDeadline()
+    {
+        return nextDeadline(*Current);
+    }
+
+#ifdef ABUTTON_WAKE
+#if !defined(BUTTON_SLEEP) && (defined(ABUTTON_PCINT) || defined(ARDUINO_ARCH_ESP32))
+    // Every button can wake the MCU: watched by the interrupts, or on a plain GPIO without interrupts
+    static bool wakeable(const AsyncButton::Config &conf)
+    {
+#ifdef BUTTON_INTERRUPT
+        return &conf == watching && conf.size <= 32 && !~conf.watched;
+#else
+        for (size_t i = 0; i < conf.size; ++i)
+            if (conf.buttons[i].pin != 255 && sourceOf(conf, conf.buttons[i].pin))
+                return false;
+        return true;
+#endif
+    }
+#endif
+
+    static bool sleep(AsyncButton::Config &conf)
+    {
+#if defined(BUTTON_SLEEP)
+        if (!isIdle(conf))
+            return false;
+        BUTTON_SLEEP();
+        return true;
+#elif defined(ABUTTON_PCINT)
+        if (!wakeable(conf) || !isIdle(conf))
+            return false;
+        // INTx edges do not wake the deeper sleep modes, pin changes do
+        uint32_t armed = 0, woken = 0;
+        for (size_t i = 0; i < conf.size; ++i)
+        {
+            uint8_t pin = conf.buttons[i].pin;
+            if (pin == 255)
+                continue;
+            woken |= (uint32_t)1 << i;
+            if (digitalPinToInterrupt(pin) != NOT_AN_INTERRUPT && watchPcint(i, pin))
+                armed |= (uint32_t)1 << i;
+        }
+        set_sleep_mode(BUTTON_SLEEP_MODE);
+        cli();
+        bool idle = isIdle(conf); // A press between the checks would otherwise sleep through
+        if (idle)
+        {
+            sleep_enable();
+            sei(); // The instruction after sei() still runs, so no interrupt slips in before sleeping
+            sleep_cpu();
+            sleep_disable();
+        }
+        sei();
+        for (size_t i = 0; armed; ++i, armed >>= 1)
+            if (armed & 1)
+                unwatchPcint(i, conf.buttons[i].pin);
+        if (idle)
+            markDirty(woken); // Look at every button once, whichever pin woke the MCU
+        return idle;
+#elif defined(ARDUINO_ARCH_ESP32)
+        if (!wakeable(conf) || !isIdle(conf))
+            return false;
+        for (size_t i = 0; i < conf.size; ++i)
+            if (conf.buttons[i].pin != 255)
+                gpio_wakeup_enable((gpio_num_t)conf.buttons[i].pin, GPIO_INTR_LOW_LEVEL);
+        esp_sleep_enable_gpio_wakeup();
+        esp_light_sleep_start();
+#ifdef BUTTON_INTERRUPT
+        uint32_t woken = 0;
+#endif
+        for (size_t i = 0; i < conf.size; ++i)
+            if (conf.buttons[i].pin != 255)
+            {
+                gpio_wakeup_disable((gpio_num_t)conf.buttons[i].pin);
+#ifdef BUTTON_INTERRUPT
+                watch(conf, i); // The wake level replaced the edge interrupt
+                woken |= (uint32_t)1 << i;
+#endif
+            }
+#ifdef BUTTON_INTERRUPT
+        markDirty(woken); // The wake press raised no edge
+#endif
+        return true;
+#else
+        (void)conf;
+        return false;
+#endif
+    }
+
+    bool sleep()
+    {
+        return sleep(*Current);
+    }
+#endif
+
+#ifdef BUTTON_SNAPSHOT
+    // Seeded so an erased or zeroed buffer never checks out
+    static uint16_t checksum(const uint8_t *data, size_t size)
+    {
+        uint8_t a = 0x5A, b = 0xA5;
+        for (size_t i = 0; i < size; ++i)
+        {
+            a += data[i];
+            b += a;
+        }
+        return (uint16_t)(a << 8 | b);
+    }
+
+    size_t snapshotSize(const AsyncButton::Config &conf)
+    {
+        return BUTTON_SNAPSHOT_SIZE(conf.size);
+    }
+
+    // Copy the Config and its buttons behind a checksum, returns the bytes written or 0 when the buffer is too small
+    size_t snapshot(const AsyncButton::Config &conf, void *buffer, size_t size)
+    {
+        size_t need = snapshotSize(conf);
+        if (!buffer || size < need)
+            return 0;
+        uint8_t *image = (uint8_t *)buffer + sizeof(uint16_t);
+#ifdef BUTTON_TIMER
+        uint8_t saved = lock();
+#endif
+        memcpy(image, (const void *)&conf, sizeof(AsyncButton::Config));
+        memcpy(image + sizeof(AsyncButton::Config), (const void *)conf.buttons, conf.size * sizeof(AsyncButton::State));
+#ifdef BUTTON_TIMER
+        unlock(saved);
+#endif
+        uint16_t check = checksum(image, need - sizeof(uint16_t));
+        memcpy(buffer, &check, sizeof(check));
+        return need;
+    }
+
+    // Bring back a snapshot of this Config, then set up the pins and interrupts again without logging
+    static bool load(AsyncButton::Config &conf, const void *buffer, size_t size)
+    {
+        size_t need = snapshotSize(conf);
+        if (!buffer || size < need)
+            return false;
+        const uint8_t *image = (const uint8_t *)buffer + sizeof(uint16_t);
+        uint16_t check;
+        memcpy(&check, buffer, sizeof(check));
+        if (check != checksum(image, need - sizeof(uint16_t)))
+            return false;
+        AsyncButton::State *buttons;
+        size_t count;
+        Time now;
+        memcpy((void *)&buttons, image + offsetof(AsyncButton::Config, buttons), sizeof(buttons));
+        memcpy(&count, image + offsetof(AsyncButton::Config, size), sizeof(count));
+        memcpy(&now, image + offsetof(AsyncButton::Config, now), sizeof(now));
+        if (buttons != conf.buttons || count != conf.size)
+            return false; // Taken from another Config or another build
+#ifdef BUTTON_RTOS
+        TaskHandle_t task = conf.task; // Owned by this run, not by the image
+        esp_timer_handle_t timer = conf.timer;
+        SemaphoreHandle_t guard = conf.guard;
+#endif
+        memcpy((void *)&conf, image, sizeof(AsyncButton::Config));
+#ifdef BUTTON_RTOS
+        conf.task = task;
+        conf.timer = timer;
+        conf.guard = guard;
+#endif
+        for (size_t i = 0; i < conf.size; ++i)
+        {
+            auto &button = conf.buttons[i];
+#ifdef BUTTON_RTOS
+            uint32_t published = button.published; // Shared with the queries of this run
+            uint8_t consumed = button.consumed, resetRequest = button.resetRequest;
+#endif
+            memcpy((void *)&button, image + sizeof(AsyncButton::Config) + i * sizeof(AsyncButton::State), sizeof(AsyncButton::State));
+#ifdef BUTTON_RTOS
+            button.published = published;
+            button.consumed = consumed;
+            button.resetRequest = resetRequest;
+#endif
+        }
+#ifdef BUTTON_TIMER
+        Time epoch = conf.epoch; // Clock of the tick count in the image
+#endif
+        init(conf, conf.callback, BUT_SILENT);
+        // Resume the clock where the snapshot stopped, the sleep does not count towards any press
+        conf.epoch = 0;
+        conf.epoch = now - timeOf(conf);
+#ifdef BUTTON_TIMER
+        if (&conf == ticking)
+        {
+            // init() cleared the counters, bring back the debounced levels and the edges latched on the old tick count
+            uint8_t saved = lock();
+            memcpy((void *)conf.lanes, image + offsetof(AsyncButton::Config, lanes), sizeof(conf.lanes));
+            for (auto &lane : conf.lanes)
+                for (size_t b = 0; b < BUTTON_VERTICAL_WIDTH; ++b)
+                {
+                    lane.pressTime[b] += epoch - conf.epoch;
+                    lane.releaseTime[b] += epoch - conf.epoch;
+                }
+            unlock(saved);
+        }
+#endif
+        conf.deadline = 0;
+#ifdef BUTTON_INTERRUPT
+        for (size_t i = 0; i < conf.size && i < 32; ++i)
+            if (conf.buttons[i].pin != 255)
+                conf.active |= (uint32_t)1 << i; // Look at every button once, the wake press raised no edge
+#endif
+        return true;
+    }
 
-    AsyncButton::Config *Current = &ButtonConfig;
-    static void (*buttonCallback)() = nullptr;
+    bool restore(AsyncButton::Config &conf, const void *buffer, size_t size)
+    {
+        if (!load(conf, buffer, size))
+            return false;
+        Current = &conf;
+        return true;
+    }
+#endif
 
-    void reset(const uint8_t pin)
+    static bool checkPress(AsyncButton::Config &conf, AsyncButton::State *button, uint8_t flags, bool reset)
     {
-        State *button = getState(pin);
         if (!button)
-            return;
-        uint8_t savedMappedPin = button->mappedPin;
-        State *savedMappedState = button->mappedState;
-        *button = {button->pin, RELEASED, false, 0, 0, RELEASED, millis(), 0, savedMappedPin, savedMappedState};
-        for (size_t i = 0; i < Current->size; ++i)
+            return false;
+        ABUTTON_PROBE(query);
+        const Timing &timing = timingOf(*button, timingOf(conf));
+        bool durationOk = !(flags & BUT_SHORT) || button->duration <= timing.longPress;
+        durationOk = durationOk && (!(flags & BUT_LONG) || button->duration > timing.longPress);
+        bool doubleOk = !(flags & BUT_DOUBLE) || button->doublePress;
+#ifdef BUTTON_COMPACT_STATE
+        bool expired = button->stale || elapsed(conf.now, button->last_time) > timing.doubleClick;
+#else
+        bool expired = elapsed(conf.now, button->last_time) > timing.doubleClick;
+#endif
+#ifdef BUTTON_IMMEDIATE
+        if (timing.flags & BUT_IMMEDIATE)
+        {
+            // Short, long and double presses are each reported once, as soon as they are known: a short press
+            // from the press edge on, a long press once held past longPress, a double press from its second edge
+            bool held = button->state == PRESSED;
+            if (!held && !button->duration)
+                return false;
+            Time length = held ? elapsed(conf.now, button->last_time) : button->duration;
+            bool lengthOk = !(flags & BUT_SHORT) || length <= timing.longPress;
+            lengthOk = lengthOk && (!(flags & BUT_LONG) || length > timing.longPress);
+            uint8_t kind = (flags & BUT_DOUBLE) ? BUT_DOUBLE : (flags & BUT_LONG) ? BUT_LONG : BUT_SHORT;
+            if ((button->reported & kind) || !lengthOk || !doubleOk)
+                return false;
+            if (reset)
+                button->reported |= kind; // Leaves the other kinds to their own queries
+            return true;
+        }
+#endif
+        bool released = button->state == RELEASED && button->duration > 0 && expired;
+        if (released && durationOk && doubleOk)
+        {
+            if (reset)
+                AsyncButton::reset(conf, button->pin);
+            return true;
+        }
+        return false;
+    }
+
+#ifdef BUTTON_RTOS
+#define ABUTTON_READY 0x100  // Published press is ready to be reported
+#define ABUTTON_LONG 0x200   // Published press was a long press
+#define ABUTTON_DOUBLE 0x400 // Published press was a double press
+
+    // Runs in the scan task: apply queries and resets from other tasks, then publish each button's press
+    static void publish(AsyncButton::Config &conf)
+    {
+        for (size_t i = 0; i < conf.size; ++i)
         {
-            auto &mappedButton = Current->buttons[i];
-            if (mappedButton.mappedPin == pin && &mappedButton != button)
+            auto &button = conf.buttons[i];
+            if (__atomic_exchange_n(&button.resetRequest, 0, __ATOMIC_ACQUIRE))
+                reset(conf, button.pin);
+            uint32_t word = button.published;
+            uint8_t serial = word & 0xFF;
+            if ((word & ABUTTON_READY) && __atomic_load_n(&button.consumed, __ATOMIC_ACQUIRE) == serial)
+            {
+                checkPress(conf, &button, BUT_NONE, true); // Reported to a query, reset it here
+#ifdef BUTTON_IMMEDIATE
+                // An immediate press keeps each kind apart, mark the ones it was published with as well
+                if (word & ABUTTON_LONG)
+                    checkPress(conf, &button, BUT_LONG, true);
+                if (word & ABUTTON_DOUBLE)
+                    checkPress(conf, &button, BUT_DOUBLE, true);
+#endif
+            }
+            uint32_t next = serial;
+            bool ready = checkPress(conf, &button, BUT_NONE, false);
+#ifdef BUTTON_IMMEDIATE
+            ready = ready || checkPress(conf, &button, BUT_LONG, false) || checkPress(conf, &button, BUT_DOUBLE, false);
+#endif
+            if (ready)
             {
-                uint8_t savedMappedPin2 = mappedButton.mappedPin;
-                State *savedMappedState2 = mappedButton.mappedState;
-                mappedButton = {mappedButton.pin, RELEASED, false, 0, 0, RELEASED, millis(), 0, savedMappedPin2, savedMappedState2};
+                if (!(word & ABUTTON_READY))
+                    next = (uint8_t)(serial + 1);
+                next |= ABUTTON_READY;
+                if (checkPress(conf, &button, BUT_LONG, false))
+                    next |= ABUTTON_LONG;
+                if (checkPress(conf, &button, BUT_DOUBLE, false))
+                    next |= ABUTTON_DOUBLE;
             }
+            if (next != word)
+                __atomic_store_n(&button.published, next, __ATOMIC_RELEASE);
         }
     }
 
-    void setup(void (*callback)(), uint8_t flags)
+    // Wait-free press query from any task, consuming a press claims its serial number
+    static bool snapshotPress(AsyncButton::State *button, uint8_t flags, bool reset)
     {
-        setup(ButtonConfig, callback, flags);
+        if (!button)
+            return false;
+        uint32_t word = __atomic_load_n(&button->published, __ATOMIC_ACQUIRE);
+        uint8_t serial = word & 0xFF;
+        uint8_t consumed = __atomic_load_n(&button->consumed, __ATOMIC_ACQUIRE);
+        if (!(word & ABUTTON_READY) || serial == consumed)
+            return false;
+        if (((flags & BUT_SHORT) && (word & ABUTTON_LONG)) ||
+            ((flags & BUT_LONG) && !(word & ABUTTON_LONG)) ||
+            ((flags & BUT_DOUBLE) && !(word & ABUTTON_DOUBLE)))
+            return false;
+        return !reset || __atomic_compare_exchange_n(&button->consumed, &consumed, serial, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
     }
 
-    void setup(AsyncButton::Config &conf, void (*callback)(), uint8_t flags)
+    static void scanTask(void *arg)
     {
-        Current = &conf;
-        buttonCallback = callback;
-#ifndef BUTTON_SERIAL_DISABLE
-        if (!(flags & BUT_SILENT))
+        AsyncButton::Config &conf = *(AsyncButton::Config *)arg;
+        for (;;)
         {
-            SERIAL.print(F(ABUTTON_LOG_PREFIX "Setup long: " ANSI_YELLOW));
-            SERIAL.print(BUTTON_LONGPRESS_TIME);
-            SERIAL.print(F(ANSI_DEFAULT " double: " ANSI_YELLOW));
-            SERIAL.print(BUTTON_DOUBLECLICK_TIME);
-            SERIAL.print(F(ANSI_DEFAULT " debounce: " ANSI_YELLOW));
-            SERIAL.print(BUTTON_DEBOUNCE_TIME);
-            SERIAL.println(F(ANSI_DEFAULT "ms"));
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            xSemaphoreTakeRecursive(conf.guard, portMAX_DELAY);
+            update(conf);
+            publish(conf);
+            xSemaphoreGiveRecursive(conf.guard);
         }
-#endif
-        for (size_t i = 0; i < Current->size; ++i)
-            if (Current->buttons[i].pin != 255)
-            {
-                pinMode(Current->buttons[i].pin, INPUT_PULLUP);
-                if (Current->buttons[i].mappedPin != 255)
-                    Current->buttons[i].mappedState = getState(Current->buttons[i].mappedPin);
-#ifndef BUTTON_SERIAL_DISABLE
-                if (!(flags & BUT_SILENT))
-                {
-                    SERIAL.print(F(ABUTTON_LOG_PREFIX "Init button on pin: " ANSI_YELLOW));
-                    SERIAL.print(Current->buttons[i].pin);
-                    SERIAL.println(F(ANSI_DEFAULT));
-                }
-#endif
-            }
     }
 
-    void update()
+    static void scanTick(void *arg)
     {
-        unsigned long now = millis();
-        for (size_t i = 0; i < Current->size; ++i)
+        xTaskNotifyGive(((AsyncButton::Config *)arg)->task);
+    }
+
+    static void stopTask(AsyncButton::Config &conf)
+    {
+        if (conf.timer)
         {
-            auto &button = Current->buttons[i];
-            if (button.pin == 255)
-                continue;
-            uint8_t reading = digitalRead(button.pin);
-            if (reading != button.lastReading)
-                button.lastChangeTime = now;
-            if ((now - button.lastChangeTime) > BUTTON_DEBOUNCE_TIME)
-            {
-                if (reading != button.state)
-                {
-                    if (reading == PRESSED)
-                    {
-                        if (now - button.last_time < BUTTON_DOUBLECLICK_TIME)
-                            button.doublePress = true;
-                        else
-                            button.doublePress = false;
-                        button.duration = 0;
-                        button.last_time = now;
-                    }
-                    else if (reading == RELEASED && button.state == PRESSED)
-                        button.duration = now - button.last_time;
-                    button.state = reading;
-                }
-            }
-            button.lastReading = reading;
-            if (reading == PRESSED &&
-                button.state == PRESSED &&
-                buttonCallback &&
-                now - button.last_time >= BUTTON_LONGPRESS_TIME &&
-                now - button.lastLongPressCallback >= BUTTON_LONGPRESS_TIME)
-            {
-                buttonCallback();
-                button.lastLongPressCallback = now;
-            }
-            if (reading == RELEASED)
-            {
-                button.lastLongPressCallback = 0;
-            }
+            esp_timer_stop(conf.timer);
+            esp_timer_delete(conf.timer);
+            conf.timer = nullptr;
         }
-        for (size_t i = 0; i < Current->size; ++i)
+        if (conf.task)
         {
-            auto &button = Current->buttons[i];
-            if (button.mappedState && button.state == PRESSED)
-            {
-                button.mappedState->state = button.state;
-                button.mappedState->duration = button.duration;
-                button.mappedState->doublePress = button.doublePress;
-                button.mappedState->last_time = button.last_time;
-            }
+            xSemaphoreTakeRecursive(conf.guard, portMAX_DELAY); // Between two scans, a task deleted mid-scan would keep the guard
+            vTaskDelete(conf.task);
+            conf.task = nullptr;
+            xSemaphoreGiveRecursive(conf.guard);
         }
     }
 
-    bool checkPress(const AsyncButton::State *button, unsigned long minDuration, unsigned long maxDuration, bool requireDouble, bool reset)
+    static bool startTask(AsyncButton::Config &conf, unsigned long period, int core)
     {
-        if (!button)
+        if (conf.task)
             return false;
-        bool durationOk = button->duration > minDuration && (maxDuration == 0 || button->duration <= maxDuration);
-        bool doubleOk = !requireDouble || button->doublePress;
-        bool released = button->state == RELEASED && button->duration > 0 && millis() - button->last_time > BUTTON_DOUBLECLICK_TIME;
-        if (released && durationOk && doubleOk)
+        if (!conf.guard && !(conf.guard = xSemaphoreCreateRecursiveMutex()))
+            return false; // Kept across stopTask(), queries may still hold it
+        for (size_t i = 0; i < conf.size; ++i)
         {
-            if (reset)
-                AsyncButton::reset(button->pin);
-            return true;
+            conf.buttons[i].published = 0;
+            conf.buttons[i].consumed = 0;
+            conf.buttons[i].resetRequest = 0;
         }
-        return false;
+        if (xTaskCreatePinnedToCore(scanTask, "AsyncButton", BUTTON_TASK_STACK, &conf, BUTTON_TASK_PRIORITY, &conf.task, core) != pdPASS)
+        {
+            conf.task = nullptr;
+            return false;
+        }
+        esp_timer_create_args_t args = {};
+        args.callback = scanTick;
+        args.arg = &conf;
+        args.name = "AsyncButton";
+        if (esp_timer_create(&args, &conf.timer) != ESP_OK || esp_timer_start_periodic(conf.timer, period) != ESP_OK)
+        {
+            stopTask(conf);
+            return false;
+        }
+        return true;
+    }
+
+    bool startTask(unsigned long period, int core)
+    {
+        return startTask(*Current, period, core);
+    }
+
+    void stopTask()
+    {
+        stopTask(*Current);
+    }
+#endif
+
+    // Press query from the application, served from the published snapshot while a scan task runs
+    static bool query(AsyncButton::Config &conf, const uint8_t pin, uint8_t flags, bool reset)
+    {
+#ifdef BUTTON_RTOS
+        if (conf.task)
+            return snapshotPress(find(conf, pin), flags, reset);
+#endif
+        return checkPress(conf, find(conf, pin), flags, reset);
     }
 
+    // Reset from the application, handed to the scan task while one runs
+    static void request(AsyncButton::Config &conf, const uint8_t pin)
+    {
+#ifdef BUTTON_RTOS
+        if (conf.task)
+        {
+            if (State *button = find(conf, pin))
+                __atomic_store_n(&button->resetRequest, 1, __ATOMIC_RELEASE);
+            return;
+        }
+#endif
+        reset(conf, pin);
+    }
+
+    void reset(const uint8_t pin)
+    {
+        request(*Current, pin);
+    }
+
+#ifdef BUTTON_READERS
+    bool consume(AsyncButton::Config &conf, uint8_t *seen, size_t size, const uint8_t pin, uint8_t flags)
+    {
+        ABUTTON_GUARD;
+        State *button = find(conf, pin);
+        size_t i = button ? button - conf.buttons : size;
+        if (i >= size || seen[i] == button->generation || !checkPress(conf, button, flags, false))
+            return false;
+        seen[i] = button->generation;
+        return true;
+    }
+#endif
+
     bool isPressed(const uint8_t pin, bool reset)
     {
-        return checkPress(getState(pin), 0, 0, false, reset);
+        return query(*Current, pin, BUT_NONE, reset);
     }
 
     bool isPressedDouble(const uint8_t pin, bool reset)
     {
-        return checkPress(getState(pin), 0, 0, true, reset);
+        return query(*Current, pin, BUT_DOUBLE, reset);
     }
 
     bool isShortPressed(const uint8_t pin, bool reset)
     {
-        return checkPress(getState(pin), 0, BUTTON_LONGPRESS_TIME, false, reset);
+        return query(*Current, pin, BUT_SHORT, reset);
     }
 
     bool isShortPressedDouble(const uint8_t pin, bool reset)
     {
-        return checkPress(getState(pin), 0, BUTTON_LONGPRESS_TIME, true, reset);
+        return query(*Current, pin, BUT_SHORT | BUT_DOUBLE, reset);
     }
 
     bool isLongPressed(const uint8_t pin, bool reset)
     {
-        return checkPress(getState(pin), BUTTON_LONGPRESS_TIME, 0, false, reset);
+        return query(*Current, pin, BUT_LONG, reset);
     }
 
     bool isLongPressedDouble(const uint8_t pin, bool reset)
     {
-        return checkPress(getState(pin), BUTTON_LONGPRESS_TIME, 0, true, reset);
+        return query(*Current, pin, BUT_LONG | BUT_DOUBLE, reset);
     }
 
-    inline AsyncButton::State *getState(const uint8_t pin)
+    // Live state, nullptr from outside a running scan task
+    static AsyncButton::State *getState(const AsyncButton::Config &conf, const uint8_t pin)
     {
-        if (pin == 255)
+#ifdef BUTTON_RTOS
+        if (offTask(conf))
             return nullptr;
-        for (size_t i = 0; i < Current->size; ++i)
-            if (Current->buttons[i].pin == pin)
-                return &Current->buttons[i];
-        return nullptr;
+#endif
+        return find(conf, pin);
+    }
+
+    inline AsyncButton::State *getState(const uint8_t pin)
+    {
+        return getState(*Current, pin);
+    }
+
+
+    ButtonGroup::ButtonGroup(AsyncButton::State *buttons, size_t size, const AsyncButton::Timing *timing)
+    {
+        config.buttons = buttons;
+        config.size = size;
+        config.timing = timing;
+    }
+
+    bool ButtonGroup::setup(void (*callback)(), uint8_t flags)
+    {
+        return init(config, callback, flags);
+    }
+
+    void ButtonGroup::update()
+    {
+        AsyncButton::update(config);
+    }
+
+    void ButtonGroup::update(unsigned long budget)
+    {
+        AsyncButton::update(config, budget);
+    }
+
+    void ButtonGroup::reset(const uint8_t pin)
+    {
+        request(config, pin);
+    }
+
+    bool ButtonGroup::isPressed(const uint8_t pin, bool reset)
+    {
+        return query(config, pin, BUT_NONE, reset);
+    }
+
+    bool ButtonGroup::isPressedDouble(const uint8_t pin, bool reset)
+    {
+        return query(config, pin, BUT_DOUBLE, reset);
+    }
+
+    bool ButtonGroup::isShortPressed(const uint8_t pin, bool reset)
+    {
+        return query(config, pin, BUT_SHORT, reset);
+    }
+
+    bool ButtonGroup::isShortPressedDouble(const uint8_t pin, bool reset)
+    {
+        return query(config, pin, BUT_SHORT | BUT_DOUBLE, reset);
+    }
+
+    bool ButtonGroup::isLongPressed(const uint8_t pin, bool reset)
+    {
+        return query(config, pin, BUT_LONG, reset);
+    }
+
+    bool ButtonGroup::isLongPressedDouble(const uint8_t pin, bool reset)
+    {
+        return query(config, pin, BUT_LONG | BUT_DOUBLE, reset);
+    }
+
+    bool ButtonGroup::isIdle()
+    {
+        return AsyncButton::isIdle(config);
+    }
+
+    AsyncButton::Time ButtonGroup::nextDeadline()
+    {
+        return AsyncButton::nextDeadline(config);
+    }
+
+#ifdef BUTTON_ENCODERS
+    bool ButtonGroup::attach(AsyncButton::Encoder *encoders, uint8_t count)
+    {
+        return AsyncButton::attach(config, encoders, count);
+    }
+
+    int16_t ButtonGroup::readEncoder(uint8_t encoder, bool reset)
+    {
+        return AsyncButton::readEncoder(config, encoder, reset);
+    }
+#endif
+
+#ifdef BUTTON_EVENT_QUEUE
+    bool ButtonGroup::poll(AsyncButton::Event &event)
+    {
+        return AsyncButton::poll(config, event);
+    }
+#endif
+
+#ifdef BUTTON_HANDLERS
+    bool ButtonGroup::on(const uint8_t pin, uint16_t events, AsyncButton::EventCallback callback, void *context)
+    {
+        return AsyncButton::on(config, pin, events, callback, context);
+    }
+
+    void ButtonGroup::off(const uint8_t pin, AsyncButton::EventCallback callback)
+    {
+        AsyncButton::off(config, pin, callback);
+    }
+#endif
+
+#ifdef BUTTON_RTOS
+    bool ButtonGroup::startTask(unsigned long period, int core)
+    {
+        return AsyncButton::startTask(config, period, core);
+    }
+
+    void ButtonGroup::stopTask()
+    {
+        AsyncButton::stopTask(config);
+    }
+#endif
+
+    bool ButtonGroup::attach(AsyncButton::Source &source)
+    {
+        return AsyncButton::attach(config, source);
+    }
+
+    bool ButtonGroup::addMapping(const uint8_t pin, const uint8_t target)
+    {
+        return AsyncButton::addMapping(config, pin, target);
+    }
+
+#ifdef BUTTON_STATS
+    const AsyncButton::Stats *ButtonGroup::getStats(const uint8_t pin)
+    {
+        return AsyncButton::getStats(config, pin);
+    }
+
+    void ButtonGroup::resetStats()
+    {
+        AsyncButton::resetStats(config);
+    }
+#endif
+
+#ifdef BUTTON_PROFILE
+    void ButtonGroup::getProfile(AsyncButton::Profile &profile)
+    {
+        AsyncButton::getProfile(config, profile);
+    }
+
+    void ButtonGroup::resetProfile()
+    {
+        AsyncButton::resetProfile(config);
+    }
+#endif
+
+#ifdef BUTTON_CHORDS
+    uint8_t ButtonGroup::addChord(const uint8_t *pins, uint8_t count, unsigned long hold, uint8_t flags)
+    {
+        return AsyncButton::addChord(config, pins, count, hold, flags);
+    }
+
+    bool ButtonGroup::isChord(uint8_t chord, bool reset)
+    {
+        return AsyncButton::isChord(config, chord, reset);
+    }
+#endif
+
+#ifdef BUTTON_REPEAT
+    uint8_t ButtonGroup::addRepeat(const uint8_t pin, unsigned long delay, unsigned long rate, unsigned long fastest, uint8_t accel, AsyncButton::RepeatCallback callback)
+    {
+        return AsyncButton::addRepeat(config, pin, delay, rate, fastest, accel, callback);
+    }
+#endif
+
+#ifdef BUTTON_GESTURES
+    uint8_t ButtonGroup::addGesture(const uint8_t pin, const char *pattern, AsyncButton::GestureCallback callback)
+    {
+        return AsyncButton::addGesture(config, pin, pattern, callback);
+    }
+
+    bool ButtonGroup::isGesture(uint8_t gesture, bool reset)
+    {
+        return AsyncButton::isGesture(config, gesture, reset);
+    }
+#endif
+
+#ifdef BUTTON_RECORD
+    void ButtonGroup::record(AsyncButton::Tape *tape)
+    {
+        AsyncButton::record(config, tape);
+    }
+
+    bool ButtonGroup::replay(AsyncButton::Tape *tape)
+    {
+        return AsyncButton::replay(config, tape);
+    }
+
+    bool ButtonGroup::isReplaying()
+    {
+        return config.tape && config.tape->replaying;
+    }
+#endif
+
+#ifdef BUTTON_SNAPSHOT
+    size_t ButtonGroup::snapshotSize()
+    {
+        return AsyncButton::snapshotSize(config);
+    }
+
+    size_t ButtonGroup::snapshot(void *buffer, size_t size)
+    {
+        return AsyncButton::snapshot(config, buffer, size);
+    }
+
+    bool ButtonGroup::restore(const void *buffer, size_t size)
+    {
+        return load(config, buffer, size);
+    }
+#endif
+
+    AsyncButton::State *ButtonGroup::getState(const uint8_t pin)
+    {
+        return AsyncButton::getState(config, pin);
+    }
+}
+
+#ifdef ABUTTON_PCINT
+#ifdef BUTTON_ENCODERS
+#define ABUTTON_PCINT_ENCODERS(bank) AsyncButton::pcintTurned(AsyncButton::pcintEncoders[bank])
+#else
+#define ABUTTON_PCINT_ENCODERS(bank)
+#endif
+#define ABUTTON_PCINT_ISR(bank)                               \
+    ISR(PCINT##bank##_vect)                                   \
+    {                                                         \
+        AsyncButton::markDirty(AsyncButton::pcintButtons[bank]); \
+        ABUTTON_PCINT_ENCODERS(bank);                          \
     }
-}
\ No newline at end of file
+#ifdef PCINT0_vect
+ABUTTON_PCINT_ISR(0)
+#endif
+#ifdef PCINT1_vect
+ABUTTON_PCINT_ISR(1)
+#endif
+#ifdef PCINT2_vect
+ABUTTON_PCINT_ISR(2)
+#endif
+#ifdef PCINT3_vect
+ABUTTON_PCINT_ISR(3)
+#endif
+#endif
+
+#ifdef ABUTTON_TIMER2
+ISR(TIMER2_COMPA_vect)
+{
+    AsyncButton::tick();
+}
+#endif
\ No newline at end of file
@@ -38,6 +38,132 @@ MIT License */
 #ifndef BUTTON_LONGPRESS_TIME
 #define BUTTON_LONGPRESS_TIME 1000 // Time to consider a long press in milliseconds
 #endif
+#ifndef BUTTON_TIME
+#define BUTTON_TIME() millis() // Clock used for all button timing, read once per update()
+#endif
+#ifndef BUTTON_PIN_TABLE_SIZE
+#define BUTTON_PIN_TABLE_SIZE 0 // Pins covered by the O(1) pin lookup table, e.g. NUM_DIGITAL_PINS (0 = linear scan)
+#endif
+#ifdef BUTTON_TIMER
+#ifndef BUTTON_VERTICAL_DEBOUNCE
+#define BUTTON_VERTICAL_DEBOUNCE // The timer samples into the vertical counters
+#endif
+#ifndef BUTTON_TIMER_PERIOD
+#define BUTTON_TIMER_PERIOD 1 // Timer sampling period with BUTTON_TIMER in milliseconds (1 = 1 kHz)
+#endif
+#endif
+#ifndef BUTTON_VERTICAL_WIDTH
+#define BUTTON_VERTICAL_WIDTH 32 // Buttons per vertical counter lane with BUTTON_VERTICAL_DEBOUNCE (8, 16 or 32)
+#endif
+#ifndef BUTTON_VERTICAL_LANES
+#define BUTTON_VERTICAL_LANES 1 // Vertical counter lanes, buttons beyond them use the per-button debounce
+#endif
+#ifndef BUTTON_VERTICAL_TICK
+#define BUTTON_VERTICAL_TICK (BUTTON_DEBOUNCE_TIME / 4 ? BUTTON_DEBOUNCE_TIME / 4 : 1) // Vertical counter sample period in milliseconds
+#endif
+#ifndef BUTTON_EVENT_QUEUE_SIZE
+#define BUTTON_EVENT_QUEUE_SIZE 16 // Event queue slots with BUTTON_EVENT_QUEUE (power of two, max 256)
+#endif
+#ifndef BUTTON_MAX_HANDLERS
+#define BUTTON_MAX_HANDLERS 8 // Event callbacks per Config with BUTTON_HANDLERS
+#endif
+#ifndef BUTTON_MAX_MAPPINGS
+#define BUTTON_MAX_MAPPINGS 0 // Max addMapping() entries per Config, on top of each button's mappedPin (0 = none, max 255)
+#endif
+#ifndef BUTTON_MAX_CHORDS
+#define BUTTON_MAX_CHORDS 4 // Chords per Config with BUTTON_CHORDS
+#endif
+#ifndef BUTTON_MAX_REPEATS
+#define BUTTON_MAX_REPEATS 4 // Auto-repeating buttons per Config with BUTTON_REPEAT (max 8)
+#endif
+#ifndef BUTTON_MAX_GESTURES
+#define BUTTON_MAX_GESTURES 8 // Press patterns per Config with BUTTON_GESTURES (max 16)
+#endif
+#ifndef BUTTON_MAX_GESTURE_NODES
+#define BUTTON_MAX_GESTURE_NODES 24 // Transition table states per Config with BUTTON_GESTURES, one per pattern prefix (max 254)
+#endif
+#ifndef BUTTON_MAX_GESTURE_BUTTONS
+#define BUTTON_MAX_GESTURE_BUTTONS 4 // Buttons with press patterns per Config with BUTTON_GESTURES (max 8)
+#endif
+#ifndef BUTTON_STATS_BINS
+#define BUTTON_STATS_BINS 8 // Press duration histogram bins per button with BUTTON_STATS
+#endif
+#ifndef BUTTON_STATS_BIN_TIME
+#define BUTTON_STATS_BIN_TIME 64 // Upper bound of the first duration bin in milliseconds, each further bin doubles it
+#endif
+#ifndef BUTTON_MAX_PORTS
+#define BUTTON_MAX_PORTS 4 // Max hardware ports sampled per update() with BUTTON_PORT_READ
+#endif
+#ifndef BUTTON_TASK_PERIOD
+#define BUTTON_TASK_PERIOD 1000 // Scan period of the BUTTON_RTOS task in microseconds
+#endif
+#ifndef BUTTON_TASK_CORE
+#define BUTTON_TASK_CORE 0 // Core running the BUTTON_RTOS task
+#endif
+#ifndef BUTTON_TASK_PRIORITY
+#define BUTTON_TASK_PRIORITY 3 // FreeRTOS priority of the BUTTON_RTOS task
+#endif
+#ifndef BUTTON_TASK_STACK
+#define BUTTON_TASK_STACK 3072 // Stack size of the BUTTON_RTOS task in bytes
+#endif
+#ifndef BUTTON_MATRIX_SETTLE
+#define BUTTON_MATRIX_SETTLE 10 // Time a driven matrix row settles before its columns are read, in microseconds
+#endif
+#if defined(__AVR__) && !defined(BUTTON_SLEEP_MODE)
+#define BUTTON_SLEEP_MODE SLEEP_MODE_PWR_DOWN // AVR sleep mode entered by sleep()
+#endif
+#if defined(BUTTON_SLEEP) || defined(ARDUINO_ARCH_ESP32) || (defined(__AVR__) && defined(BUTTON_INTERRUPT) && defined(digitalPinToPCICR) && !defined(BUTTON_PCINT_DISABLE))
+#define ABUTTON_WAKE // A button press can wake the MCU from sleep()
+#endif
+#if defined(BUTTON_PROFILE) && !defined(BUTTON_PROFILE_CLOCK)
+#if defined(ARDUINO_ARCH_ESP32)
+#define BUTTON_PROFILE_CLOCK() ESP.getCycleCount() // Clock timing the profiled calls, in CPU cycles
+#else
+#define BUTTON_PROFILE_CLOCK() micros() // Clock timing the profiled calls, in microseconds
+#endif
+#endif
+
+#if defined(BUTTON_INTERRUPT) && !defined(NOT_AN_INTERRUPT)
+#define NOT_AN_INTERRUPT -1
+#endif
+#if (defined(BUTTON_INTERRUPT) || defined(BUTTON_TIMER) || defined(BUTTON_ENCODERS)) && !defined(IRAM_ATTR)
+#define IRAM_ATTR
+#endif
+
+#if defined(BUTTON_TIMER) && defined(BUTTON_INTERRUPT)
+#error "AsyncButton: BUTTON_TIMER and BUTTON_INTERRUPT cannot be combined"
+#endif
+
+#ifdef BUTTON_RTOS
+#ifndef ARDUINO_ARCH_ESP32
+#error "AsyncButton: BUTTON_RTOS requires an ESP32"
+#endif
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+#include <esp_timer.h>
+#endif
+
+#if defined(BUTTON_EVENT_QUEUE) && (BUTTON_EVENT_QUEUE_SIZE & (BUTTON_EVENT_QUEUE_SIZE - 1) || BUTTON_EVENT_QUEUE_SIZE > 256)
+#error "AsyncButton: BUTTON_EVENT_QUEUE_SIZE must be a power of two up to 256"
+#endif
+
+#if defined(BUTTON_EVENT_QUEUE) && (defined(BUTTON_INTERRUPT) || defined(BUTTON_TIMER))
+#define ABUTTON_EDGES // The pin interrupts or tick() queue the edges they see with their times, update() replays them
+#endif
+
+#if defined(BUTTON_REPEAT) && BUTTON_MAX_REPEATS > 8
+#error "AsyncButton: BUTTON_MAX_REPEATS must be at most 8"
+#endif
+
+#if defined(BUTTON_GESTURES) && (BUTTON_MAX_GESTURES > 16 || BUTTON_MAX_GESTURE_NODES > 254 || BUTTON_MAX_GESTURE_BUTTONS > 8)
+#error "AsyncButton: BUTTON_GESTURES supports at most 16 patterns, 254 nodes and 8 buttons per Config"
+#endif
+
+#if defined(BUTTON_PORT_READ) && !(defined(portInputRegister) && defined(digitalPinToPort) && defined(digitalPinToBitMask))
+#warning "AsyncButton: BUTTON_PORT_READ is not supported on this core, falling back to digitalRead()"
+#undef BUTTON_PORT_READ
+#endif
 
 #define PRESSED LOW   // Button pressed state
 #define RELEASED HIGH // Button released state
@@ -47,8 +173,80 @@ MIT License */
 #define BUT_SHORT 0x01
 #define BUT_LONG 0x02
 #define BUT_DOUBLE 0x04
+#ifdef BUTTON_IMMEDIATE
+#define BUT_IMMEDIATE 0x08 // Timing flag: report presses at the debounced press edge
+#endif
+#define BUT_SWALLOW 0x10   // Chord flag: drop the member buttons' own presses once the chord fires
 #define BUT_SILENT 0x80
 
+// Event types:
+#define BUTTON_EVENT_PRESS 0   // Debounced press edge
+#define BUTTON_EVENT_RELEASE 1 // Debounced release edge
+#define BUTTON_EVENT_SHORT 2   // Released within BUTTON_LONGPRESS_TIME
+#define BUTTON_EVENT_LONG 3    // Released after BUTTON_LONGPRESS_TIME
+#define BUTTON_EVENT_DOUBLE 4  // Released second press of a double press
+#define BUTTON_EVENT_HOLD 5    // Held for another BUTTON_LONGPRESS_TIME
+#define BUTTON_EVENT_CHORD 6   // Chord held for its hold time, pin is the chord number
+#define BUTTON_EVENT_REPEAT 7  // Auto-repeat of a held button, count is the repeat number
+#define BUTTON_EVENT_TURN_CW 8  // Encoder turned one detent clockwise, pin is its A pin
+#define BUTTON_EVENT_TURN_CCW 9 // Encoder turned one detent counter-clockwise, pin is its A pin
+#define BUTTON_EVENT_GESTURE 10 // Press pattern completed, count is the pattern number
+
+#define BUTTON_EVENT_BIT(type) (1u << (type)) // Event mask bit for on()
+#define BUTTON_EVENT_ALL 0xFFFF               // Event mask matching every event type
+#define BUTTON_ANY_PIN 255                    // Handler pin matching every button
+#define BUTTON_NO_DEADLINE ((AsyncButton::Time)~0) // nextDeadline() when only a pin change can start new work
+
+// State initializers for a button on pin, mapped to mappedPin (255 = no mapping), using a Timing profile;
+// the default layout also takes the positional {pin, RELEASED, false, 0, 0, RELEASED, 0, 0, mappedPin, nullptr} of 1.x:
+#if defined(BUTTON_COMPACT_STATE) && defined(BUTTON_IMMEDIATE)
+#define ABUTTON_STATE_FIELDS(pin, mappedPin) (uint8_t)(pin), RELEASED, RELEASED, false, true, false, 0, 0, 0, 0, (uint8_t)(mappedPin)
+#elif defined(BUTTON_COMPACT_STATE)
+#define ABUTTON_STATE_FIELDS(pin, mappedPin) (uint8_t)(pin), RELEASED, RELEASED, false, true, 0, 0, 0, 0, (uint8_t)(mappedPin)
+#else
+#define ABUTTON_STATE_FIELDS(pin, mappedPin) (uint8_t)(pin), RELEASED, false, 0, 0, RELEASED, 0, 0, (uint8_t)(mappedPin), nullptr
+#endif
+#if defined(BUTTON_IMMEDIATE) && !defined(BUTTON_COMPACT_STATE)
+#define ABUTTON_STATE_REPORTED , false
+#else
+#define ABUTTON_STATE_REPORTED
+#endif
+#ifdef BUTTON_READERS
+#define ABUTTON_STATE_READERS , 0
+#else
+#define ABUTTON_STATE_READERS
+#endif
+#ifdef BUTTON_PORT_READ
+#define ABUTTON_STATE_PORT , 0, 0
+#else
+#define ABUTTON_STATE_PORT
+#endif
+#ifdef BUTTON_RTOS
+#define ABUTTON_STATE_RTOS , 0, 0, 0
+#else
+#define ABUTTON_STATE_RTOS
+#endif
+#if BUTTON_MAX_MAPPINGS > 0
+#define ABUTTON_STATE_DERIVED , 255, 255, 255, 255, 255
+#else
+#define ABUTTON_STATE_DERIVED , 255, 255, 255
+#endif
+#define ABUTTON_STATE_TAIL ABUTTON_STATE_REPORTED ABUTTON_STATE_READERS ABUTTON_STATE_PORT ABUTTON_STATE_RTOS ABUTTON_STATE_DERIVED
+#ifdef BUTTON_TIMING_PROFILES
+#define BUTTON_STATE_TIMING(pin, mappedPin, timing) {ABUTTON_STATE_FIELDS(pin, mappedPin), (timing) ABUTTON_STATE_TAIL}
+#define BUTTON_STATE(pin, mappedPin) BUTTON_STATE_TIMING(pin, mappedPin, nullptr)
+#else
+#define BUTTON_STATE(pin, mappedPin) {ABUTTON_STATE_FIELDS(pin, mappedPin) ABUTTON_STATE_TAIL}
+#endif
+
+// Encoder initializer for quadrature pins a and b with steps transitions per detent (4, 2 or 1):
+#ifdef BUTTON_PORT_READ
+#define ABUTTON_ENCODER_PORT , 0, 0, 0, 0
+#else
+#define ABUTTON_ENCODER_PORT
+#endif
+#define BUTTON_ENCODER(a, b, steps) {(uint8_t)(a), (uint8_t)(b), (uint8_t)(steps), 0, 0, 0, 0, false ABUTTON_ENCODER_PORT}
+
 // Define ANSI color codes if not already defined:
 #ifndef ANSI_GRAY
 #define ANSI_GRAY ""
@@ -62,9 +260,73 @@ MIT License */
 
 namespace AsyncButton
 {
+#ifdef BUTTON_PORT_READ
+#if defined(__AVR__)
+    typedef uint8_t PortWord; // Width of a hardware input port register
+#else
+    typedef uint32_t PortWord; // Width of a hardware input port register
+#endif
+#endif
+
+#ifdef BUTTON_COMPACT_STATE
+    typedef uint16_t Time; // Timestamp and duration type stored per button
+#else
+    typedef unsigned long Time; // Timestamp and duration type stored per button
+#endif
+
+#ifdef BUTTON_VERTICAL_DEBOUNCE
+#if BUTTON_VERTICAL_WIDTH == 8
+    typedef uint8_t VerticalWord; // One bit per button in a vertical counter lane
+#elif BUTTON_VERTICAL_WIDTH == 16
+    typedef uint16_t VerticalWord; // One bit per button in a vertical counter lane
+#elif BUTTON_VERTICAL_WIDTH == 32
+    typedef uint32_t VerticalWord; // One bit per button in a vertical counter lane
+#else
+#error "AsyncButton: BUTTON_VERTICAL_WIDTH must be 8, 16 or 32"
+#endif
+
+    struct Lane
+    {
+        VerticalWord cnt0;  // Low bit of each button's two-bit sample counter
+        VerticalWord cnt1;  // High bit of each button's two-bit sample counter
+        VerticalWord state; // Debounced state, one bit per button (1 = PRESSED)
+        VerticalWord open;  // Released buttons with a deadline still ahead, such as a double click window
+#ifdef BUTTON_STATS
+        VerticalWord raw;   // Readings at the last sample, for counting bounces between counter ticks
+#endif
+#ifdef BUTTON_TIMER
+        VerticalWord pressed;  // Buttons debounced to PRESSED since the last update() (set by tick())
+        VerticalWord released; // Buttons debounced to RELEASED since the last update() (set by tick())
+        Time pressTime[BUTTON_VERTICAL_WIDTH];   // Time of each button's latest press (set by tick())
+        Time releaseTime[BUTTON_VERTICAL_WIDTH]; // Time of each button's latest release (set by tick())
+#endif
+    };
+#endif
+
+    struct Timing
+    {
+        Time debounce;    // Debounce time in milliseconds
+        Time doubleClick; // Time to consider a double click in milliseconds
+        Time longPress;   // Time to consider a long press in milliseconds
+        uint8_t flags;    // Behaviour flags (BUT_IMMEDIATE)
+    };
+
     struct State
     {
         uint8_t pin;                         // Pin number for the button
+#ifdef BUTTON_COMPACT_STATE
+        uint8_t state : 1;                   // Current state of the button (PRESSED/RELEASED)
+        uint8_t lastReading : 1;             // Last reading of the button state
+        uint8_t doublePress : 1;             // Flag for double press detection
+        uint8_t stale : 1;                   // last_time is older than the double click window
+#ifdef BUTTON_IMMEDIATE
+        uint8_t reported : 3;                // Immediate short, long and double press already reported (BUT_SHORT/BUT_LONG/BUT_DOUBLE bits)
+#endif
+        Time duration;                       // Duration the button has been pressed
+        Time last_time;                      // Last time the button state was changed
+        Time lastChangeTime;                 // Last time the button state changed
+        Time lastLongPressCallback;          // Last time long press callback was called
+#else
         uint8_t state;                       // Current state of the button (PRESSED/RELEASED)
         bool doublePress;                    // Flag for double press detection
         unsigned long duration;              // Duration the button has been pressed
@@ -72,27 +334,760 @@ namespace AsyncButton
         uint8_t lastReading;                 // Last reading of the button state
         unsigned long lastChangeTime;        // Last time the button state changed
         unsigned long lastLongPressCallback; // Last time long press callback was called
+#endif
         uint8_t mappedPin;                   // Pin of the button this maps to (255 = no mapping)
-        State *mappedState;                  // Direct pointer to the mapped button's State
+#ifndef BUTTON_COMPACT_STATE
+        State *mappedState;                  // Direct pointer to the mapped button's State (set by setup())
+#endif
+#ifdef BUTTON_TIMING_PROFILES
+        const Timing *timing;                // Timing profile of this button (nullptr = Config timing)
+#endif
+#if defined(BUTTON_IMMEDIATE) && !defined(BUTTON_COMPACT_STATE)
+        uint8_t reported;                    // Immediate short, long and double press already reported (BUT_SHORT/BUT_LONG/BUT_DOUBLE bits)
+#endif
+#ifdef BUTTON_READERS
+        uint8_t generation;                  // Count of completed presses, wraps around
+#endif
+#ifdef BUTTON_PORT_READ
+        uint8_t port;                        // Index + 1 of the sampled port register (0 = digitalRead, set by setup())
+        PortWord mask;                       // Bit mask of the pin in its port register (set by setup())
+#endif
+#ifdef BUTTON_RTOS
+        uint32_t published;                  // Press snapshot written by the scan task
+        uint8_t consumed;                    // Serial of the last press reported to a query
+        uint8_t resetRequest;                // reset() requested by another task
+#endif
+        // Derived by setup() and kept last, so positional initializers of the fields above keep compiling
+        uint8_t mappedIndex;                 // Index of the button mappedPin maps to (255 = none)
+        uint8_t firstMapper;                 // Index of the first button whose mappedPin maps to this one (255 = none)
+        uint8_t nextMapper;                  // Index of the next button with the same mappedPin target (255 = none)
+#if BUTTON_MAX_MAPPINGS > 0
+        uint8_t firstLink;                   // First kept addMapping() entry of this button (255 = none)
+        uint8_t firstLinked;                 // First kept addMapping() entry pressing this button (255 = none)
+#endif
+    };
+
+    struct Event
+    {
+        uint8_t type;  // Event type (BUTTON_EVENT_*)
+        uint8_t pin;   // Pin of the button
+        Time time;     // Time the event occurred
+        Time duration; // Press duration for release events
+#if defined(BUTTON_REPEAT) || defined(BUTTON_GESTURES)
+        uint16_t count; // Repeat number for repeat events (starting at 1), pattern number for gesture events
+#endif
+    };
+
+#ifdef ABUTTON_EDGES
+    struct Edge
+    {
+        uint8_t index; // Index of the button
+        uint8_t level; // Debounced level (PRESSED/RELEASED)
+        Time time;     // Time the level was accepted, on the clock of the sampling path
+    };
+#endif
+
+    typedef void (*EventCallback)(const AsyncButton::Event &event, void *context);
+
+    struct Handler
+    {
+        uint8_t pin;            // Pin to listen on (BUTTON_ANY_PIN = all buttons)
+        uint16_t events;        // Mask of BUTTON_EVENT_BIT() types to deliver
+        EventCallback callback; // Function called from update()
+        void *context;          // User pointer passed to the callback
+    };
+
+    struct Mapping
+    {
+        uint8_t pin;     // Pin of the mapping button
+        uint8_t target;  // Pin of the button it presses
+        uint8_t from;    // Index of the mapping button (255 = entry dropped, set by setup())
+        uint8_t to;      // Index of the button it presses (set by setup())
+        uint8_t nextOut; // Next kept entry of the same mapping button (255 = none, set by setup())
+        uint8_t nextIn;  // Next kept entry pressing the same button (255 = none, set by setup())
+    };
+
+#ifdef BUTTON_CHORDS
+    struct Chord
+    {
+        uint32_t mask; // Buttons held together, one bit per index in Config buttons (set by addChord())
+        Time hold;     // Time all of them must be held before the chord fires
+        Time since;    // Time they were first all pressed
+        uint8_t flags; // Chord flags (BUT_SWALLOW)
+        bool held;     // All of them are pressed
+        bool fired;    // Fired during the current hold
+        bool pending;  // Fired and not reported by isChord() yet
+    };
+#endif
+
+#ifdef BUTTON_REPEAT
+    typedef void (*RepeatCallback)(uint8_t pin, uint16_t count);
+
+    struct Repeat
+    {
+        uint8_t button;          // Index of the held button in Config buttons (set by addRepeat())
+        Time delay;              // Hold time before the first repeat
+        Time rate;               // Interval between the first repeats
+        Time fastest;            // Shortest interval the acceleration reaches
+        uint8_t accel;           // Percent each repeat shortens the interval by (0 = constant rate)
+        RepeatCallback callback; // Called on each repeat (nullptr = events only)
+        Time since;              // Time of the last repeat, or of the press
+        Time wait;               // Interval from since to the next repeat
+        uint16_t count;          // Repeats during the current hold
+    };
+#endif
+
+#ifdef BUTTON_GESTURES
+    typedef void (*GestureCallback)(uint8_t pin, uint8_t gesture);
+
+    struct Gesture
+    {
+        uint8_t button;           // Index of the button in Config buttons (set by addGesture())
+        GestureCallback callback; // Called when the pattern completes (nullptr = events and isGesture() only)
+    };
+
+    // State of the transition table, reached by the presses of one pattern prefix
+    struct GestureNode
+    {
+        uint8_t next[2]; // Node after a short (0) or long (1) press, 0 = no pattern continues this way
+        uint8_t gesture; // Pattern completed at this node, 255 = none
+    };
+
+    struct Sequence
+    {
+        uint8_t button; // Index of the button in Config buttons
+        uint8_t root;   // Node of the empty sequence
+        uint8_t node;   // Node reached by the presses so far, 255 = matches no pattern
+        Time since;     // Release of the last press
+    };
+#endif
+
+#ifdef BUTTON_RECORD
+    // Debounced edge in a recording, 3 bytes on AVR and 4 with the padding of 32-bit boards
+    struct Mark
+    {
+        uint16_t delta; // Milliseconds since the previous mark (bits 0-14, pauses are capped), bit 15 set = press
+        uint8_t pin;    // Pin of the button
+    };
+
+    // Ring buffer of recorded edges, replayed into update() in place of the pins
+    struct Tape
+    {
+        Mark *marks;     // Storage for the marks
+        uint16_t size;   // Number of entries in marks
+        uint16_t head;   // Next entry written, the oldest mark once the tape is full
+        uint16_t count;  // Marks recorded, the newest overwrite the oldest
+        uint16_t cursor; // Marks already replayed
+        Time last;       // Time of the newest mark recorded or replayed
+        uint32_t levels; // Replayed presses of the first 32 buttons, one bit each
+        bool replaying;  // update() reads the buttons from the marks
+    };
+
+#define BUTTON_TAPE(marks) {(marks), (uint16_t)(sizeof(marks) / sizeof(AsyncButton::Mark)), 0, 0, 0, 0, 0, false}
+#endif
+
+#ifdef BUTTON_ENCODERS
+    struct Encoder
+    {
+        uint8_t pinA;             // Pin of the A contact, leading when turned clockwise
+        uint8_t pinB;             // Pin of the B contact
+        uint8_t steps;            // Quadrature transitions per detent (4, 2 or 1)
+        uint8_t phase;            // Last A/B reading, A in bit 1 (set by the decoder)
+        int8_t sub;               // Transitions counted towards the next detent (set by the decoder)
+        volatile int16_t pending; // Detents decoded and not yet taken by update()
+        int16_t delta;            // Detents turned since the last readEncoder() with reset, clockwise positive
+        bool watched;             // Decoded by interrupts or tick() instead of update() (set by setup())
+#ifdef BUTTON_PORT_READ
+        uint8_t portA, portB; // Index + 1 of the sampled ports of the pins (0 = digitalRead, set by setup())
+        PortWord maskA, maskB; // Bit masks of the pins in their ports (set by setup())
+#endif
+    };
+#endif
+
+    // Input hardware providing the readings of a range of virtual pins
+    class Source
+    {
+    public:
+        Source(uint8_t base, uint8_t count) : base(base), count(count), next(nullptr), first(255) {}
+        virtual void begin() {}                        // Configure the hardware (called by setup())
+        virtual void scan() = 0;                       // Sample the hardware without blocking (called by update())
+        virtual uint8_t read(uint8_t index) const = 0; // Reading (PRESSED/RELEASED) of virtual pin base + index
+
+        const uint8_t base;  // First virtual pin
+        const uint8_t count; // Number of virtual pins
+        Source *next;        // Next source of the same Config (set by attach())
+        uint8_t first;       // Button index of virtual pin base when its buttons are listed in key order (255 = scan, set by setup())
+    };
+
+#ifdef BUTTON_STATS
+    struct Stats
+    {
+        uint16_t presses;                      // Completed presses
+        uint16_t longs;                        // Presses longer than the long press time
+        uint16_t doubles;                      // Second presses of a double press
+        uint16_t bounces;                      // Readings that went back before the debounce accepted them
+        uint16_t durations[BUTTON_STATS_BINS]; // Press durations: bin 0 below BUTTON_STATS_BIN_TIME, each next bin twice as long
+    };
+#endif
+
+#ifdef BUTTON_PROFILE
+    struct Span
+    {
+        uint32_t count;   // Timed calls
+        uint32_t min;     // Shortest call in BUTTON_PROFILE_CLOCK() ticks
+        uint32_t max;     // Longest call in BUTTON_PROFILE_CLOCK() ticks
+        uint32_t total;   // Sum of all calls in BUTTON_PROFILE_CLOCK() ticks
+        uint32_t average; // Average call, total / count (set by getProfile())
+    };
+
+    struct Profile
+    {
+        Span update;         // update() calls
+        Span query;          // Press queries evaluated by checkPress()
+        Span reset;          // reset() calls
+        uint32_t events;     // Events emitted
+        uint32_t eventRate;  // Events per second (set by getProfile())
+        Time latency;        // Worst time from a debounced edge to the delivery of its event
+        unsigned long since; // BUTTON_TIME() at the last resetProfile()
+    };
+#endif
+
+    // Virtual pins without hardware, used as logical actions pressed through the mapping graph
+    class Actions : public Source
+    {
+    public:
+        Actions(uint8_t base, uint8_t count) : Source(base, count) {}
+        void scan() override {}
+        uint8_t read(uint8_t) const override { return RELEASED; }
     };
 
     struct Config
     {
-        State *buttons; // Array of button states
-        size_t size;    // Size of the array
+        State *buttons;       // Array of button states
+        size_t size;          // Size of the array
+        const Timing *timing; // Timing for all buttons (nullptr = BUTTON_*_TIME settings)
+        Source *sources;      // Sources of virtual pins (set by attach())
+#if BUTTON_PIN_TABLE_SIZE > 0
+        uint8_t index[BUTTON_PIN_TABLE_SIZE]; // Index + 1 of the button on each pin (set by setup())
+        bool indexed;                         // Lookup table is valid
+#endif
+        size_t cursor;      // Next button of a time-budgeted update()
+        void (*callback)(); // Long press callback (set by setup())
+        Time now;           // Clock at the last update(), used by the press queries
+        Time deadline;      // Time after now until update() next has work (set by update())
+#if BUTTON_MAX_MAPPINGS > 0
+        Mapping mappings[BUTTON_MAX_MAPPINGS]; // Mappings added by addMapping(), on top of each mappedPin
+        uint8_t mappingCount;                  // Number of used entries in mappings
+#endif
+#ifdef BUTTON_RTOS
+        TaskHandle_t task;          // Scan task (set by startTask())
+        esp_timer_handle_t timer;   // Timer waking the scan task (set by startTask())
+        SemaphoreHandle_t guard;    // Held by the scan task around each scan and by queries from other tasks (set by startTask())
+#endif
+#ifdef BUTTON_PORT_READ
+        const volatile PortWord *ports[BUTTON_MAX_PORTS]; // Input registers read once per update() (set by setup())
+        uint8_t portCount;                                 // Number of used entries in ports
+#endif
+#ifdef BUTTON_EVENT_QUEUE
+        Event events[BUTTON_EVENT_QUEUE_SIZE]; // Ring buffer written by update(), drained by poll()
+        volatile uint8_t head;                 // Next slot written by update()
+        volatile uint8_t tail;                 // Next slot read by poll()
+        uint8_t dropped;                       // Events lost to a full queue
+#ifdef ABUTTON_EDGES
+        Edge edges[BUTTON_EVENT_QUEUE_SIZE]; // Ring buffer written by the interrupts or tick(), drained by update()
+        volatile uint8_t edgeHead;           // Next slot written by the sampling path
+        volatile uint8_t edgeTail;           // Next slot read by update()
+#endif
+#endif
+#ifdef BUTTON_HANDLERS
+        Handler handlers[BUTTON_MAX_HANDLERS]; // Registered event callbacks
+        uint8_t handlerCount;                  // Number of used entries in handlers
+#endif
+#ifdef BUTTON_CHORDS
+        Chord chords[BUTTON_MAX_CHORDS]; // Chords evaluated by update()
+        uint8_t chordCount;              // Number of used entries in chords
+        uint32_t pressed;                // Pressed buttons among the first 32
+        uint32_t swallowed;              // Buttons whose press was taken by a chord
+#endif
+#ifdef BUTTON_ENCODERS
+        Encoder *encoders;    // Rotary encoders decoded alongside the buttons (set by attach())
+        uint8_t encoderCount; // Number of entries in encoders
+#endif
+#ifdef BUTTON_REPEAT
+        Repeat repeats[BUTTON_MAX_REPEATS]; // Auto-repeating buttons
+        uint8_t repeatCount;                // Number of used entries in repeats
+        uint8_t repeating;                  // Entries whose button is held, one bit each
+#endif
+#ifdef BUTTON_GESTURES
+        Gesture gestures[BUTTON_MAX_GESTURES];             // Press patterns added with addGesture()
+        uint8_t gestureCount;                              // Number of used entries in gestures
+        uint16_t recognized;                               // Patterns completed and not reported by isGesture() yet, one bit each
+        GestureNode nodes[BUTTON_MAX_GESTURE_NODES];       // Transition table compiled from the patterns
+        uint8_t nodeCount;                                 // Number of used entries in nodes
+        Sequence sequences[BUTTON_MAX_GESTURE_BUTTONS];    // Press sequence of each button with patterns
+        uint8_t sequenceCount;                             // Number of used entries in sequences
+        uint8_t sequencing;                                // Sequences waiting for their next press, one bit each
+#endif
+#ifdef BUTTON_RECORD
+        Tape *tape; // Recording or replay of the debounced edges (set by record() and replay(), nullptr = none)
+#endif
+#ifdef BUTTON_SNAPSHOT
+        Time epoch; // Added to the clock so it resumes where a restored snapshot stopped
+#endif
+#ifdef BUTTON_STATS
+        Stats *stats; // Counters parallel to buttons, updated by update() (nullptr = none)
+#endif
+#ifdef BUTTON_PROFILE
+        Profile profile; // Timings of this configuration (read by getProfile())
+#endif
+#ifdef BUTTON_INTERRUPT
+        uint32_t watched; // Buttons whose pin changes raise an interrupt (set by setup())
+        uint32_t active;  // Buttons that are pressed or still debouncing
+#endif
+#ifdef BUTTON_VERTICAL_DEBOUNCE
+        Lane lanes[BUTTON_VERTICAL_LANES]; // Bit-parallel debounce counters for the first buttons
+        Time lastTick;                     // Last time the vertical counters were clocked
+#endif
     };
 
+// Config initializer for an array of size button states, the remaining fields start cleared:
+#if BUTTON_PIN_TABLE_SIZE > 0
+#define ABUTTON_CONFIG_INDEX , {}, false
+#else
+#define ABUTTON_CONFIG_INDEX
+#endif
+#if BUTTON_MAX_MAPPINGS > 0
+#define ABUTTON_CONFIG_MAPPINGS , {}, 0
+#else
+#define ABUTTON_CONFIG_MAPPINGS
+#endif
+#ifdef BUTTON_RTOS
+#define ABUTTON_CONFIG_RTOS , nullptr, nullptr, nullptr
+#else
+#define ABUTTON_CONFIG_RTOS
+#endif
+#ifdef BUTTON_PORT_READ
+#define ABUTTON_CONFIG_PORT , {}, 0
+#else
+#define ABUTTON_CONFIG_PORT
+#endif
+#ifdef ABUTTON_EDGES
+#define ABUTTON_CONFIG_EVENTS , {}, 0, 0, 0, {}, 0, 0
+#elif defined(BUTTON_EVENT_QUEUE)
+#define ABUTTON_CONFIG_EVENTS , {}, 0, 0, 0
+#else
+#define ABUTTON_CONFIG_EVENTS
+#endif
+#ifdef BUTTON_HANDLERS
+#define ABUTTON_CONFIG_HANDLERS , {}, 0
+#else
+#define ABUTTON_CONFIG_HANDLERS
+#endif
+#ifdef BUTTON_CHORDS
+#define ABUTTON_CONFIG_CHORDS , {}, 0, 0, 0
+#else
+#define ABUTTON_CONFIG_CHORDS
+#endif
+#ifdef BUTTON_ENCODERS
+#define ABUTTON_CONFIG_ENCODERS , nullptr, 0
+#else
+#define ABUTTON_CONFIG_ENCODERS
+#endif
+#ifdef BUTTON_REPEAT
+#define ABUTTON_CONFIG_REPEAT , {}, 0, 0
+#else
+#define ABUTTON_CONFIG_REPEAT
+#endif
+#ifdef BUTTON_GESTURES
+#define ABUTTON_CONFIG_GESTURES , {}, 0, 0, {}, 0, {}, 0, 0
+#else
+#define ABUTTON_CONFIG_GESTURES
+#endif
+#ifdef BUTTON_RECORD
+#define ABUTTON_CONFIG_RECORD , nullptr
+#else
+#define ABUTTON_CONFIG_RECORD
+#endif
+#ifdef BUTTON_SNAPSHOT
+#define ABUTTON_CONFIG_SNAPSHOT , 0
+#else
+#define ABUTTON_CONFIG_SNAPSHOT
+#endif
+#ifdef BUTTON_STATS
+#define ABUTTON_CONFIG_STATS , nullptr
+#else
+#define ABUTTON_CONFIG_STATS
+#endif
+#ifdef BUTTON_PROFILE
+#define ABUTTON_CONFIG_PROFILE , {}
+#else
+#define ABUTTON_CONFIG_PROFILE
+#endif
+#ifdef BUTTON_INTERRUPT
+#define ABUTTON_CONFIG_INTERRUPT , 0, 0
+#else
+#define ABUTTON_CONFIG_INTERRUPT
+#endif
+#ifdef BUTTON_VERTICAL_DEBOUNCE
+#define ABUTTON_CONFIG_VERTICAL , {}, 0
+#else
+#define ABUTTON_CONFIG_VERTICAL
+#endif
+#define BUTTON_CONFIG(buttons, size) {(buttons), (size_t)(size), nullptr, nullptr ABUTTON_CONFIG_INDEX, 0, nullptr, 0, 0 ABUTTON_CONFIG_MAPPINGS \
+    ABUTTON_CONFIG_RTOS ABUTTON_CONFIG_PORT ABUTTON_CONFIG_EVENTS ABUTTON_CONFIG_HANDLERS ABUTTON_CONFIG_CHORDS ABUTTON_CONFIG_ENCODERS ABUTTON_CONFIG_REPEAT \
+    ABUTTON_CONFIG_GESTURES ABUTTON_CONFIG_RECORD ABUTTON_CONFIG_SNAPSHOT ABUTTON_CONFIG_STATS ABUTTON_CONFIG_PROFILE ABUTTON_CONFIG_INTERRUPT ABUTTON_CONFIG_VERTICAL}
+
+#ifndef BUTTON_NO_DEFAULT_CONFIG
     extern AsyncButton::Config ButtonConfig;
+#endif
     extern AsyncButton::Config *Current;
     void reset(const uint8_t pin);
-    void setup(void (*callback)() = nullptr, uint8_t flags = BUT_NONE);
-    void setup(AsyncButton::Config &conf, void (*callback)() = nullptr, uint8_t flags = BUT_NONE);
+#ifndef BUTTON_NO_DEFAULT_CONFIG
+    bool setup(void (*callback)() = nullptr, uint8_t flags = BUT_NONE);
+#endif
+    bool setup(AsyncButton::Config &conf, void (*callback)() = nullptr, uint8_t flags = BUT_NONE);
     void update();
+    void update(unsigned long budget);
+#ifdef BUTTON_RTOS
+    bool startTask(unsigned long period = BUTTON_TASK_PERIOD, int core = BUTTON_TASK_CORE);
+    void stopTask();
+#endif
+#ifdef BUTTON_TIMER
+    void tick();
+#endif
     bool isPressed(const uint8_t pin, bool reset = true);
     bool isPressedDouble(const uint8_t pin, bool reset = true);
     bool isShortPressed(const uint8_t pin, bool reset = true);
     bool isShortPressedDouble(const uint8_t pin, bool reset = true);
     bool isLongPressed(const uint8_t pin, bool reset = true);
     bool isLongPressedDouble(const uint8_t pin, bool reset = true);
+    bool isIdle();
+#ifdef ABUTTON_WAKE
+    bool sleep();
+#else
+    // Without a wake source, a call to sleep() fails to compile instead of never sleeping
+    template <bool Wake = false>
+    bool sleep()
+    {
+        static_assert(Wake, "AsyncButton: sleep() needs BUTTON_INTERRUPT on AVR (without BUTTON_PCINT_DISABLE), an ESP32 or BUTTON_SLEEP()");
+        return false;
+    }
+#endif
+    AsyncButton::Time nextDeadline();
+#ifdef BUTTON_EVENT_QUEUE
+    bool poll(AsyncButton::Event &event);
+#endif
+#ifdef BUTTON_HANDLERS
+    bool on(const uint8_t pin, uint16_t events, AsyncButton::EventCallback callback, void *context = nullptr);
+    void off(const uint8_t pin, AsyncButton::EventCallback callback);
+#endif
+#ifdef BUTTON_STATS
+    const AsyncButton::Stats *getStats(const uint8_t pin);
+    void resetStats();
+#endif
+#ifdef BUTTON_PROFILE
+    void getProfile(AsyncButton::Profile &profile);
+    void resetProfile();
+#endif
+    bool attach(AsyncButton::Config &conf, AsyncButton::Source &source);
+    bool addMapping(AsyncButton::Config &conf, const uint8_t pin, const uint8_t target);
+#ifdef BUTTON_CHORDS
+    uint8_t addChord(AsyncButton::Config &conf, const uint8_t *pins, uint8_t count, unsigned long hold, uint8_t flags = BUT_NONE);
+    bool isChord(uint8_t chord, bool reset = true);
+#endif
+#ifdef BUTTON_ENCODERS
+    bool attach(AsyncButton::Config &conf, AsyncButton::Encoder *encoders, uint8_t count);
+    int16_t readEncoder(uint8_t encoder, bool reset = true);
+#endif
+#ifdef BUTTON_REPEAT
+    uint8_t addRepeat(AsyncButton::Config &conf, const uint8_t pin, unsigned long delay, unsigned long rate, unsigned long fastest = 0, uint8_t accel = 0, AsyncButton::RepeatCallback callback = nullptr);
+#endif
+#ifdef BUTTON_GESTURES
+    uint8_t addGesture(AsyncButton::Config &conf, const uint8_t pin, const char *pattern, AsyncButton::GestureCallback callback = nullptr);
+    bool isGesture(uint8_t gesture, bool reset = true);
+#endif
+#ifdef BUTTON_RECORD
+    void record(AsyncButton::Config &conf, AsyncButton::Tape *tape);
+    bool replay(AsyncButton::Config &conf, AsyncButton::Tape *tape);
+    bool isReplaying();
+#endif
+#ifdef BUTTON_SNAPSHOT
+#define BUTTON_SNAPSHOT_SIZE(buttons) (sizeof(uint16_t) + sizeof(AsyncButton::Config) + (buttons) * sizeof(AsyncButton::State)) // Bytes of a snapshot
+    size_t snapshotSize(const AsyncButton::Config &conf);
+    size_t snapshot(const AsyncButton::Config &conf, void *buffer, size_t size);
+    bool restore(AsyncButton::Config &conf, const void *buffer, size_t size);
+#endif
     inline AsyncButton::State *getState(const uint8_t pin);
+#ifdef BUTTON_READERS
+    bool consume(AsyncButton::Config &conf, uint8_t *seen, size_t size, const uint8_t pin, uint8_t flags);
+#endif
+    void update(AsyncButton::Config &conf);
+    AsyncButton::Time step(AsyncButton::Config &conf, AsyncButton::State &button, uint8_t reading, AsyncButton::Time now, const AsyncButton::Timing &timing);
+
+    // Independent set of buttons with its own callback, timing, lookup tables and events, never touching Current
+    class ButtonGroup
+    {
+    public:
+        ButtonGroup(AsyncButton::State *buttons, size_t size, const AsyncButton::Timing *timing = nullptr);
+        bool setup(void (*callback)() = nullptr, uint8_t flags = BUT_NONE);
+        void update();
+        void update(unsigned long budget);
+        void reset(const uint8_t pin);
+        bool isPressed(const uint8_t pin, bool reset = true);
+        bool isPressedDouble(const uint8_t pin, bool reset = true);
+        bool isShortPressed(const uint8_t pin, bool reset = true);
+        bool isShortPressedDouble(const uint8_t pin, bool reset = true);
+        bool isLongPressed(const uint8_t pin, bool reset = true);
+        bool isLongPressedDouble(const uint8_t pin, bool reset = true);
+        bool isIdle();
+        AsyncButton::Time nextDeadline();
+#ifdef BUTTON_EVENT_QUEUE
+        bool poll(AsyncButton::Event &event);
+#endif
+#ifdef BUTTON_HANDLERS
+        bool on(const uint8_t pin, uint16_t events, AsyncButton::EventCallback callback, void *context = nullptr);
+        void off(const uint8_t pin, AsyncButton::EventCallback callback);
+#endif
+#ifdef BUTTON_RTOS
+        bool startTask(unsigned long period = BUTTON_TASK_PERIOD, int core = BUTTON_TASK_CORE);
+        void stopTask();
+#endif
+        bool attach(AsyncButton::Source &source);
+        bool addMapping(const uint8_t pin, const uint8_t target);
+#ifdef BUTTON_STATS
+        const AsyncButton::Stats *getStats(const uint8_t pin);
+        void resetStats();
+#endif
+#ifdef BUTTON_PROFILE
+        void getProfile(AsyncButton::Profile &profile);
+        void resetProfile();
+#endif
+#ifdef BUTTON_CHORDS
+        uint8_t addChord(const uint8_t *pins, uint8_t count, unsigned long hold, uint8_t flags = BUT_NONE);
+        bool isChord(uint8_t chord, bool reset = true);
+#endif
+#ifdef BUTTON_ENCODERS
+        bool attach(AsyncButton::Encoder *encoders, uint8_t count);
+        int16_t readEncoder(uint8_t encoder, bool reset = true);
+#endif
+#ifdef BUTTON_REPEAT
+        uint8_t addRepeat(const uint8_t pin, unsigned long delay, unsigned long rate, unsigned long fastest = 0, uint8_t accel = 0, AsyncButton::RepeatCallback callback = nullptr);
+#endif
+#ifdef BUTTON_GESTURES
+        uint8_t addGesture(const uint8_t pin, const char *pattern, AsyncButton::GestureCallback callback = nullptr);
+        bool isGesture(uint8_t gesture, bool reset = true);
+#endif
+#ifdef BUTTON_RECORD
+        void record(AsyncButton::Tape *tape);
+        bool replay(AsyncButton::Tape *tape);
+        bool isReplaying();
+#endif
+#ifdef BUTTON_SNAPSHOT
+        size_t snapshotSize();
+        size_t snapshot(void *buffer, size_t size);
+        bool restore(const void *buffer, size_t size);
+#endif
+        AsyncButton::State *getState(const uint8_t pin);
+        AsyncButton::Config &getConfig() { return config; }
+
+    private:
+        AsyncButton::Config config{}; // Cleared, a group may live on the stack or the heap
+    };
+
+#if !defined(BUTTON_INTERRUPT) && !defined(BUTTON_VERTICAL_DEBOUNCE) && !defined(BUTTON_TIMER) && !defined(BUTTON_RECORD) && !defined(BUTTON_SNAPSHOT) && !defined(BUTTON_ENCODERS) && !defined(BUTTON_CHORDS) && !defined(BUTTON_REPEAT) && !defined(BUTTON_GESTURES) && !defined(BUTTON_PROFILE)
+#define ABUTTON_PANEL_UNROLLED // None of the features needing the generic update() pass are compiled in
+#endif
+
+    // Button panel with pins and timing fixed at compile time, storing exactly one State per pin
+    template <unsigned long Debounce, unsigned long DoubleClick, unsigned long LongPress, uint8_t... Pins>
+    class Panel
+    {
+    public:
+        static constexpr size_t size = sizeof...(Pins);
+        static constexpr AsyncButton::Timing timing = {Debounce, DoubleClick, LongPress, 0};
+        static_assert(size > 0, "AsyncButton::Panel needs at least one pin");
+
+        // Initialize the panel and make it the active configuration, false when another one owns the interrupts or the timer
+        bool setup(void (*callback)() = nullptr, uint8_t flags = BUT_NONE)
+        {
+            static const uint8_t pins[] = {Pins...};
+            for (size_t i = 0; i < size; ++i)
+                buttons[i] = BUTTON_STATE(pins[i], 255);
+            config.buttons = buttons;
+            config.size = size;
+            config.timing = &timing;
+            return AsyncButton::setup(config, callback, flags);
+        }
+
+        // Sample and debounce every pin, the per-pin loop is unrolled at compile time unless a source or a compiled feature needs the generic pass
+        void update()
+        {
+#ifdef ABUTTON_PANEL_UNROLLED
+            if (config.sources)
+            {
+                AsyncButton::update(config); // Virtual pins are read through their sources
+                return;
+            }
+            AsyncButton::Time now = config.now = (AsyncButton::Time)BUTTON_TIME();
+            config.deadline = BUTTON_NO_DEADLINE;
+#ifdef BUTTON_PORT_READ
+            AsyncButton::PortWord sample[BUTTON_MAX_PORTS];
+            for (uint8_t p = 0; p < config.portCount; ++p)
+                sample[p] = *config.ports[p];
+#else
+            const void *sample = nullptr;
+#endif
+            size_t i = 0;
+            int unroll[] = {(step(config, buttons[i], read<Pins>(buttons[i], sample), now, timing), ++i, 0)...};
+            (void)unroll;
+#else
+            AsyncButton::update(config);
+#endif
+        }
+
+        AsyncButton::Config &getConfig() { return config; }
+
+    private:
+        template <uint8_t Pin>
+        static uint8_t read(const AsyncButton::State &button, const void *sample)
+        {
+#ifdef BUTTON_PORT_READ
+            if (button.port)
+                return (((const AsyncButton::PortWord *)sample)[button.port - 1] & button.mask) ? HIGH : LOW;
+#else
+            (void)button;
+            (void)sample;
+#endif
+            return digitalRead(Pin);
+        }
+
+        AsyncButton::State buttons[size];
+        AsyncButton::Config config{}; // Cleared, a panel may live on the stack or the heap
+    };
+
+    template <unsigned long Debounce, unsigned long DoubleClick, unsigned long LongPress, uint8_t... Pins>
+    constexpr AsyncButton::Timing Panel<Debounce, DoubleClick, LongPress, Pins...>::timing;
+
+    // Panel using the global BUTTON_*_TIME settings
+    template <uint8_t... Pins>
+    using DefaultPanel = Panel<BUTTON_DEBOUNCE_TIME, BUTTON_DOUBLECLICK_TIME, BUTTON_LONGPRESS_TIME, Pins...>;
+
+    // Key matrix driving one row per update(), key (row, col) is virtual pin base + row * Cols + col
+    template <uint8_t Rows, uint8_t Cols>
+    class Matrix : public Source
+    {
+    public:
+        static_assert(Rows > 0 && Cols > 0 && Cols <= 16, "AsyncButton::Matrix supports 1 to 16 columns");
+        static_assert(Rows * Cols < 256, "AsyncButton::Matrix supports at most 255 keys");
+
+        Matrix(const uint8_t (&rowPins)[Rows], const uint8_t (&colPins)[Cols], uint8_t base, uint16_t settle = BUTTON_MATRIX_SETTLE)
+            : Source(base, Rows * Cols), settle(settle)
+        {
+            memcpy(rows, rowPins, Rows);
+            memcpy(cols, colPins, Cols);
+        }
+
+        void begin() override
+        {
+            for (uint8_t r = 0; r < Rows; ++r)
+                pinMode(rows[r], INPUT); // Idle rows float so pressed keys cannot short two rows
+            for (uint8_t c = 0; c < Cols; ++c)
+                pinMode(cols[c], INPUT_PULLUP);
+            memset(pending, 0, sizeof(pending));
+            memset(frame, 0, sizeof(frame));
+            ghostFrames = 0;
+            row = 0;
+            drive();
+        }
+
+        // Read the driven row once it has settled, then drive the next one and return
+        void scan() override
+        {
+            if ((unsigned long)(micros() - driven) < settle)
+                return;
+            uint16_t bits = 0;
+            for (uint8_t c = 0; c < Cols; ++c)
+                if (digitalRead(cols[c]) == LOW)
+                    bits |= (uint16_t)1 << c;
+            pending[row] = bits;
+            pinMode(rows[row], INPUT);
+            if (++row == Rows)
+            {
+                row = 0;
+                publish();
+            }
+            drive();
+        }
+
+        uint8_t read(uint8_t index) const override
+        {
+            return (frame[index / Cols] >> (index % Cols)) & 1 ? PRESSED : RELEASED;
+        }
+
+        uint16_t ghosts() const { return ghostFrames; } // Full scans in which ghosting rows were held back
+
+    private:
+        void drive()
+        {
+            digitalWrite(rows[row], LOW);
+            pinMode(rows[row], OUTPUT);
+            driven = micros();
+        }
+
+        // Publish a complete scan, rows sharing two or more pressed columns may show a phantom key and keep their last frame
+        void publish()
+        {
+            bool ghosted[Rows] = {};
+            bool any = false;
+            for (uint8_t a = 0; a < Rows; ++a)
+                for (uint8_t b = a + 1; b < Rows; ++b)
+                {
+                    uint16_t common = pending[a] & pending[b];
+                    if (common & (common - 1))
+                        ghosted[a] = ghosted[b] = any = true;
+                }
+            for (uint8_t r = 0; r < Rows; ++r)
+                if (!ghosted[r])
+                    frame[r] = pending[r];
+            if (any && ghostFrames < 0xFFFF)
+                ghostFrames++;
+        }
+
+        uint8_t rows[Rows];      // Row pins, driven LOW one at a time
+        uint8_t cols[Cols];      // Column pins, read with INPUT_PULLUP
+        uint16_t settle;         // Row settle time in microseconds
+        uint8_t row;             // Row currently driven
+        unsigned long driven;    // Time the current row was driven, in microseconds
+        uint16_t pending[Rows];  // Pressed columns of the scan in progress
+        uint16_t frame[Rows];    // Pressed columns of the last complete scan
+        uint16_t ghostFrames;    // Complete scans with ghosting
+    };
+
+#ifdef BUTTON_READERS
+    // Independent consumer of the presses of a Config, each Reader sees every press once without resetting it
+    template <size_t N>
+    class Reader
+    {
+    public:
+        explicit Reader(AsyncButton::Config &conf) : conf(conf) { memset(seen, 0, sizeof(seen)); }
+
+        bool isPressed(const uint8_t pin) { return consume(conf, seen, N, pin, BUT_NONE); }
+        bool isPressedDouble(const uint8_t pin) { return consume(conf, seen, N, pin, BUT_DOUBLE); }
+        bool isShortPressed(const uint8_t pin) { return consume(conf, seen, N, pin, BUT_SHORT); }
+        bool isShortPressedDouble(const uint8_t pin) { return consume(conf, seen, N, pin, BUT_SHORT | BUT_DOUBLE); }
+        bool isLongPressed(const uint8_t pin) { return consume(conf, seen, N, pin, BUT_LONG); }
+        bool isLongPressedDouble(const uint8_t pin) { return consume(conf, seen, N, pin, BUT_LONG | BUT_DOUBLE); }
+
+        // Mark every press so far as seen, e.g. for a Reader created after the buttons were used
+        void sync()
+        {
+            for (size_t i = 0; i < N && i < conf.size; ++i)
+                seen[i] = conf.buttons[i].generation;
+        }
+
+    private:
+        AsyncButton::Config &conf;
+        uint8_t seen[N]; // Generation of each button last reported by this Reader
+    };
+#endif
 }
\ No newline at end of file
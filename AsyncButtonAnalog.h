@@ -0,0 +1,175 @@
+/* AsyncButtonAnalog.h - Analog resistor ladder source for AsyncButton
+Copyright (c) 2025 by breadbaker
+MIT License */
+#pragma once
+#include <AsyncButton.h>
+
+#ifndef BUTTON_LADDER_INTERVAL
+#define BUTTON_LADDER_INTERVAL 1000 // Minimum time between two ladder conversions in microseconds
+#endif
+#ifndef BUTTON_LADDER_TOLERANCE
+#define BUTTON_LADDER_TOLERANCE 40 // Default distance of a reading from a key's level that still selects it, in ADC counts
+#endif
+
+#ifndef IRAM_ATTR
+#define IRAM_ATTR
+#endif
+
+#if defined(__AVR__) && defined(ADCSRA) && defined(ADSC) && !defined(BUTTON_LADDER_ANALOGREAD)
+#define ABUTTON_LADDER_AVR // Split-phase conversions on the AVR ADC registers
+#endif
+
+namespace AsyncButton
+{
+    // Keys buttons on one analog pin through a resistor ladder, key k is virtual pin base + k
+    template <uint8_t Keys>
+    class Ladder : public Source
+    {
+    public:
+        static_assert(Keys > 0 && Keys < 255, "AsyncButton::Ladder supports 1 to 254 keys");
+
+        // levels[k] is the ADC reading while key k is held, in any order, the array must outlive the ladder
+        Ladder(uint8_t pin, const uint16_t (&levels)[Keys], uint8_t base, uint16_t tolerance = BUTTON_LADDER_TOLERANCE, unsigned long interval = BUTTON_LADDER_INTERVAL)
+            : Source(base, Keys), pin(pin), levels(levels), tolerance(tolerance), interval(interval), last(0), key(255), candidate(255), sample(0), fresh(false), fed(false), converting(false) {}
+
+        void begin() override
+        {
+            pinMode(pin, INPUT);
+#ifdef ABUTTON_LADDER_AVR
+            mux = channel();
+#endif
+        }
+
+        // Finish the conversion started by the previous call, then start the next one, never waiting for the ADC
+        void scan() override
+        {
+            if (fed)
+            {
+                if (fresh)
+                {
+                    fresh = false;
+                    classify(sample);
+                }
+                return;
+            }
+#ifdef ABUTTON_LADDER_AVR
+            if (converting)
+            {
+                if (ADCSRA & _BV(ADSC))
+                    return; // Still converting, look again next update()
+                converting = false;
+                if (selected())
+                    classify(ADC);
+                // Otherwise analogRead() took the ADC for another pin meanwhile, drop the reading
+            }
+            if (!due())
+                return;
+#if defined(ADCSRB) && defined(MUX5)
+            ADCSRB = (ADCSRB & ~_BV(MUX5)) | (mux & 0x20 ? _BV(MUX5) : 0);
+#endif
+            ADMUX = (ADMUX & 0xC0) | (mux & 0x07); // Keep the reference selected by analogReference(), an EXTERNAL AREF must never see AVcc
+            ADCSRA |= _BV(ADSC);
+            converting = true;
+#else
+            if (due())
+                classify(analogRead(pin)); // No split-phase ADC access on this core, rate limited to one conversion per interval
+#endif
+        }
+
+        uint8_t read(uint8_t index) const override
+        {
+            return index == key ? PRESSED : RELEASED;
+        }
+
+        // Hand over a reading from a free-running or interrupt-driven ADC, the ladder then stops converting itself
+        void IRAM_ATTR feed(uint16_t reading)
+        {
+            sample = reading;
+            fresh = true;
+            fed = true;
+        }
+
+        uint8_t pressed() const { return key; } // Key currently held, 255 = none
+
+    private:
+        bool due()
+        {
+            unsigned long now = micros();
+            if ((unsigned long)(now - last) < interval)
+                return false;
+            last = now;
+            return true;
+        }
+
+        // Nearest key within tolerance, selected once two readings in a row agree on it
+        void classify(uint16_t reading)
+        {
+            uint8_t nearest = 255;
+            uint16_t best = tolerance + 1;
+            for (uint8_t k = 0; k < Keys; ++k)
+            {
+                uint16_t distance = reading > levels[k] ? reading - levels[k] : levels[k] - reading;
+                if (distance < best)
+                {
+                    best = distance;
+                    nearest = k;
+                }
+            }
+            if (nearest == candidate)
+                key = nearest;
+            candidate = nearest;
+        }
+
+#ifdef ABUTTON_LADDER_AVR
+        // ADC channel of the pin, mirroring analogRead()
+        uint8_t channel() const
+        {
+            uint8_t p = pin;
+#if defined(analogPinToChannel)
+#if defined(__AVR_ATmega32U4__)
+            if (p >= 18)
+                p -= 18;
+#endif
+            p = analogPinToChannel(p);
+#elif defined(__AVR_ATmega1280__) || defined(__AVR_ATmega2560__)
+            if (p >= 54)
+                p -= 54;
+#elif defined(__AVR_ATmega32U4__)
+            if (p >= 18)
+                p -= 18;
+#elif defined(__AVR_ATmega1284__) || defined(__AVR_ATmega1284P__) || defined(__AVR_ATmega644__) || defined(__AVR_ATmega644A__) || defined(__AVR_ATmega644P__) || defined(__AVR_ATmega644PA__)
+            if (p >= 24)
+                p -= 24;
+#else
+            if (p >= 14)
+                p -= 14;
+#endif
+            return (p & 0x07) | (p & 0x08 ? 0x20 : 0);
+        }
+
+        // The ADC multiplexer still points at the pin, including MUX5 on the 2560 and 32U4
+        bool selected() const
+        {
+#if defined(ADCSRB) && defined(MUX5)
+            if (!(ADCSRB & _BV(MUX5)) != !(mux & 0x20))
+                return false;
+#endif
+            return (ADMUX & 0x07) == (mux & 0x07);
+        }
+
+        uint8_t mux; // ADC channel of the pin, bit 5 = MUX5
+#endif
+
+        uint8_t pin;                     // Analog input pin
+        const uint16_t (&levels)[Keys];  // ADC reading of each key
+        uint16_t tolerance;              // Largest distance from a level still selecting its key
+        unsigned long interval;          // Minimum time between conversions in microseconds
+        unsigned long last;              // Start of the last conversion in microseconds
+        uint8_t key;                     // Key read by update(), 255 = none
+        uint8_t candidate;               // Key of the last reading, 255 = none
+        volatile uint16_t sample;        // Last reading handed over by feed()
+        volatile bool fresh;             // sample not classified yet
+        bool fed;                        // Readings come from feed()
+        bool converting;                 // A conversion was started by scan()
+    };
+}
@@ -0,0 +1,66 @@
+/* AsyncButtonExpander.h - Bank of expander inputs, the base of the shift register and I2C expander sources for AsyncButton
+Copyright (c) 2025 by breadbaker
+MIT License */
+#pragma once
+#include <AsyncButton.h>
+
+#ifndef BUTTON_EXPANDER_INTERVAL
+#define BUTTON_EXPANDER_INTERVAL 1000 // Minimum time between two bank transfers in microseconds
+#endif
+
+namespace AsyncButton
+{
+    // Bank of active-low inputs fetched as whole bytes, bit b of byte n is virtual pin base + n * 8 + b
+    template <uint8_t Bytes>
+    class Bank : public Source
+    {
+    public:
+        static_assert(Bytes > 0 && Bytes < 32, "AsyncButton::Bank supports 1 to 31 bytes");
+
+        // The first transfer is due at once
+        Bank(uint8_t base, unsigned long interval) : Source(base, Bytes * 8), interval(interval), last(0UL - interval), frames(0), errors(0)
+        {
+            memset(frame, 0xFF, sizeof(frame));
+        }
+
+        uint8_t read(uint8_t index) const override
+        {
+            return (frame[index >> 3] >> (index & 7)) & 1 ? RELEASED : PRESSED;
+        }
+
+        uint16_t transfers() const { return frames; }   // Completed bank transfers
+        uint16_t failures() const { return errors; }    // Failed bank transfers, the last frame was kept
+
+    protected:
+        // Rate limit transfers, failed ones included, update() keeps using the last complete frame in between
+        bool due()
+        {
+            unsigned long now = micros();
+            if ((unsigned long)(now - last) < interval)
+                return false;
+            last = now;
+            return true;
+        }
+
+        // Count a transfer completed into frame
+        void publish()
+        {
+            if (frames < 0xFFFF)
+                frames++;
+        }
+
+        void fail()
+        {
+            if (errors < 0xFFFF)
+                errors++;
+        }
+
+        uint8_t frame[Bytes];    // Last complete transfer, read by update()
+        unsigned long interval;  // Minimum time between transfers in microseconds
+        unsigned long last;      // Start of the last transfer in microseconds
+
+    private:
+        uint16_t frames;
+        uint16_t errors;
+    };
+}
@@ -0,0 +1,62 @@
+/* AsyncButtonMcp23017.h - MCP23017 I2C expander source for AsyncButton
+Copyright (c) 2025 by breadbaker
+MIT License */
+#pragma once
+#include <AsyncButtonExpander.h>
+#include <Wire.h>
+
+#ifndef BUTTON_I2C_TIMEOUT
+#define BUTTON_I2C_TIMEOUT 2000 // Longest wait of a stuck I2C transfer in microseconds on cores with Wire timeouts (0 = leave the bus as it is)
+#endif
+
+namespace AsyncButton
+{
+    // MCP23017 I2C expander with pull-ups on all 16 inputs, GPA0-7 then GPB0-7
+    class Mcp23017 : public Bank<2>
+    {
+    public:
+        Mcp23017(uint8_t base, uint8_t address = 0x20, unsigned long interval = BUTTON_EXPANDER_INTERVAL, TwoWire &wire = Wire)
+            : Bank<2>(base, interval), address(address), wire(wire) {}
+
+        void begin() override
+        {
+            wire.begin();
+#if defined(WIRE_HAS_TIMEOUT) && BUTTON_I2C_TIMEOUT > 0
+            wire.setWireTimeout(BUTTON_I2C_TIMEOUT, true); // A stuck bus fails the read instead of hanging update()
+#endif
+            write(0x00, 0xFF, 0xFF); // IODIRA/B: all inputs
+            write(0x0C, 0xFF, 0xFF); // GPPUA/B: all pull-ups
+        }
+
+        // Read GPIOA and GPIOB in one transaction, a failed read keeps the last frame
+        void scan() override
+        {
+            if (!due())
+                return;
+            wire.beginTransmission(address);
+            wire.write((uint8_t)0x12); // GPIOA, GPIOB follows with sequential addressing
+            if (wire.endTransmission(false) != 0 || wire.requestFrom(address, (uint8_t)2) != 2)
+            {
+                fail();
+                return;
+            }
+            frame[0] = wire.read();
+            frame[1] = wire.read();
+            publish();
+        }
+
+    private:
+        void write(uint8_t reg, uint8_t a, uint8_t b)
+        {
+            wire.beginTransmission(address);
+            wire.write(reg);
+            wire.write(a);
+            wire.write(b);
+            if (wire.endTransmission() != 0)
+                fail();
+        }
+
+        uint8_t address; // I2C address (0x20-0x27)
+        TwoWire &wire;
+    };
+}
@@ -0,0 +1,47 @@
+/* AsyncButtonShift165.h - 74HC165 shift register chain source for AsyncButton
+Copyright (c) 2025 by breadbaker
+MIT License */
+#pragma once
+#include <AsyncButtonExpander.h>
+#include <SPI.h>
+
+#ifndef BUTTON_SHIFT_CLOCK
+#define BUTTON_SHIFT_CLOCK 4000000 // SPI clock for 74HC165 chains in Hz
+#endif
+
+namespace AsyncButton
+{
+    // Chain of Bytes 74HC165 shift registers read over SPI, byte 0 is the register driving MISO
+    template <uint8_t Bytes>
+    class Shift165 : public Bank<Bytes>
+    {
+    public:
+        Shift165(uint8_t latchPin, uint8_t base, unsigned long interval = BUTTON_EXPANDER_INTERVAL, SPIClass &spi = SPI)
+            : Bank<Bytes>(base, interval), latchPin(latchPin), spi(spi) {}
+
+        void begin() override
+        {
+            pinMode(latchPin, OUTPUT);
+            digitalWrite(latchPin, HIGH);
+            spi.begin();
+        }
+
+        // Latch all inputs, then clock the whole chain out in one SPI transaction of Bytes * 8 clocks
+        void scan() override
+        {
+            if (!this->due())
+                return;
+            digitalWrite(latchPin, LOW);
+            digitalWrite(latchPin, HIGH);
+            spi.beginTransaction(SPISettings(BUTTON_SHIFT_CLOCK, MSBFIRST, SPI_MODE0));
+            for (uint8_t b = 0; b < Bytes; ++b)
+                this->frame[b] = spi.transfer(0);
+            spi.endTransaction();
+            this->publish();
+        }
+
+    private:
+        uint8_t latchPin; // SH/LD pin, inputs are latched while LOW
+        SPIClass &spi;
+    };
+}
@@ -0,0 +1,85 @@
+/*
+  AsyncButton Expander Example
+
+  Demonstrates buttons read through bus expanders:
+  - 16 buttons on two chained 74HC165 shift registers (SPI)
+  - 16 buttons on an MCP23017 I/O expander (I2C)
+  - Each bank is fetched with one bus transaction, at most once per millisecond
+
+  Hardware:
+  - 74HC165 chain: SH/LD on pin 10, CLK on SCK, QH of the first register on MISO
+  - MCP23017 at address 0x20 on SDA/SCL, pull-ups are enabled by the library
+  - Connect buttons between the expander inputs and ground
+
+  Created by breadbaker, 2025
+  This example code is in the public domain.
+*/
+
+#include <AsyncButtonShift165.h>
+#include <AsyncButtonMcp23017.h>
+
+#define LATCH_PIN 10
+#define CHAIN_BASE 100    // Shift register inputs are virtual pins 100-115
+#define EXPANDER_BASE 120 // MCP23017 inputs are virtual pins 120-135
+
+AsyncButton::Shift165<2> chain(LATCH_PIN, CHAIN_BASE);
+AsyncButton::Mcp23017 expander(EXPANDER_BASE);
+
+AsyncButton::State buttons[32];
+AsyncButton::Config buttonConfig = BUTTON_CONFIG(buttons, 32);
+
+void setup()
+{
+    Serial.begin(115200);
+    while (!Serial)
+    {
+        ; // Wait for serial port to connect (needed for native USB)
+    }
+
+    Serial.println("AsyncButton Expander Example");
+    Serial.println("============================");
+
+    for (uint8_t i = 0; i < 16; ++i)
+    {
+        buttons[i] = BUTTON_STATE(CHAIN_BASE + i, 255);
+        buttons[16 + i] = BUTTON_STATE(EXPANDER_BASE + i, 255);
+    }
+
+    // Sources are attached before setup()
+    AsyncButton::attach(buttonConfig, chain);
+    AsyncButton::attach(buttonConfig, expander);
+    AsyncButton::setup(buttonConfig);
+
+    Serial.println("Press any button");
+    Serial.println();
+}
+
+void loop()
+{
+    // Must call update() regularly, it fetches a bank once its transfer interval has passed
+    AsyncButton::update();
+
+    for (uint8_t i = 0; i < 32; ++i)
+    {
+        uint8_t pin = buttons[i].pin;
+        if (AsyncButton::isLongPressed(pin))
+        {
+            Serial.print("Long press on virtual pin ");
+            Serial.println(pin);
+        }
+        else if (AsyncButton::isPressed(pin))
+        {
+            Serial.print("Press on virtual pin ");
+            Serial.println(pin);
+        }
+    }
+
+    // Failed reads keep the last frame, report them once
+    static uint16_t failures = 0;
+    if (expander.failures() != failures)
+    {
+        failures = expander.failures();
+        Serial.print("I2C read failures: ");
+        Serial.println(failures);
+    }
+}
@@ -0,0 +1,76 @@
+/*
+  AsyncButton Keypad Example
+
+  Demonstrates a 4x4 key matrix:
+  - 16 keys on 8 pins, one row is driven per update()
+  - Each key is a virtual pin with its own debounce, double and long press
+  - Phantom keys from ghosting are suppressed
+
+  Hardware:
+  - Connect the keypad rows to pins 2-5 and the columns to pins 6-9
+  - The library enables INPUT_PULLUP on the columns
+
+  Created by breadbaker, 2025
+  This example code is in the public domain.
+*/
+
+#include <AsyncButton.h>
+
+// Define matrix pins - modify these for your hardware
+const uint8_t rowPins[4] = {2, 3, 4, 5};
+const uint8_t colPins[4] = {6, 7, 8, 9};
+
+// Keys are virtual pins 100-115, row by row
+#define KEY_BASE 100
+const char keyNames[16] = {'1', '2', '3', 'A', '4', '5', '6', 'B', '7', '8', '9', 'C', '*', '0', '#', 'D'};
+
+AsyncButton::Matrix<4, 4> keypad(rowPins, colPins, KEY_BASE);
+AsyncButton::State keys[16];
+AsyncButton::Config keyConfig = BUTTON_CONFIG(keys, 16);
+
+void setup()
+{
+    Serial.begin(115200);
+    while (!Serial)
+    {
+        ; // Wait for serial port to connect (needed for native USB)
+    }
+
+    Serial.println("AsyncButton Keypad Example");
+    Serial.println("==========================");
+
+    for (uint8_t i = 0; i < 16; ++i)
+        keys[i] = BUTTON_STATE(KEY_BASE + i, 255);
+
+    // Sources are attached before setup()
+    AsyncButton::attach(keyConfig, keypad);
+    AsyncButton::setup(keyConfig);
+
+    Serial.println("Press keys, hold one for a long press");
+    Serial.println();
+}
+
+void loop()
+{
+    // Must call update() regularly, each call scans one row
+    AsyncButton::update();
+
+    for (uint8_t i = 0; i < 16; ++i)
+    {
+        if (AsyncButton::isLongPressed(KEY_BASE + i))
+        {
+            Serial.print("Long press: ");
+            Serial.println(keyNames[i]);
+        }
+        else if (AsyncButton::isPressedDouble(KEY_BASE + i))
+        {
+            Serial.print("Double press: ");
+            Serial.println(keyNames[i]);
+        }
+        else if (AsyncButton::isPressed(KEY_BASE + i))
+        {
+            Serial.print("Key: ");
+            Serial.println(keyNames[i]);
+        }
+    }
+}
@@ -48,13 +48,13 @@ void onLongPress()
 // Custom button configuration with mapping
 // CONFIRM button maps to OK button (pressing CONFIRM also triggers OK state)
 AsyncButton::State buttons[] = {
-    // Pin, State, DoublePress, Duration, LastTime, LastReading, LastChangeTime, LastLongPressCallback, MappedPin, MappedState
-    {BUTTON_OK_PIN, RELEASED, false, 0, 0, RELEASED, 0, 0, 255, nullptr},                // OK button (no mapping)
-    {BUTTON_CONFIRM_PIN, RELEASED, false, 0, 0, RELEASED, 0, 0, BUTTON_OK_PIN, nullptr}, // CONFIRM maps to OK
-    {BUTTON_CANCEL_PIN, RELEASED, false, 0, 0, RELEASED, 0, 0, 255, nullptr},            // CANCEL button (no mapping)
+    // Pin, MappedPin
+    BUTTON_STATE(BUTTON_OK_PIN, 255),                // OK button (no mapping)
+    BUTTON_STATE(BUTTON_CONFIRM_PIN, BUTTON_OK_PIN), // CONFIRM maps to OK
+    BUTTON_STATE(BUTTON_CANCEL_PIN, 255),            // CANCEL button (no mapping)
 };
 
-AsyncButton::Config buttonConfig = {buttons, 3};
+AsyncButton::Config buttonConfig = BUTTON_CONFIG(buttons, 3);
 
 void setup()
 {
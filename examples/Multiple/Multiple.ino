@@ -27,12 +27,12 @@
 
 // Custom button configuration
 AsyncButton::State buttons[] = {
-    {BUTTON_OK_PIN, RELEASED, false, 0, 0, RELEASED, 0, 0, 255, nullptr},      // OK button
-    {BUTTON_CANCEL_PIN, RELEASED, false, 0, 0, RELEASED, 0, 0, 255, nullptr},  // CANCEL button
-    {BUTTON_CONFIRM_PIN, RELEASED, false, 0, 0, RELEASED, 0, 0, 255, nullptr}, // CONFIRM button
+    BUTTON_STATE(BUTTON_OK_PIN, 255),      // OK button
+    BUTTON_STATE(BUTTON_CANCEL_PIN, 255),  // CANCEL button
+    BUTTON_STATE(BUTTON_CONFIRM_PIN, 255), // CONFIRM button
 };
 
-AsyncButton::Config buttonConfig = {buttons, 3};
+AsyncButton::Config buttonConfig = BUTTON_CONFIG(buttons, 3);
 
 // Simple menu state
 int menuItem = 0;
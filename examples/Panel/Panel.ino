@@ -0,0 +1,77 @@
+/*
+  AsyncButton Panel Example
+
+  Demonstrates a button panel configured at compile time:
+  - Pins and timing are template parameters
+  - Storage holds exactly one State per pin
+  - The per-button update loop is unrolled by the compiler
+
+  Hardware:
+  - Connect buttons between pins 2, 3, 4 and ground
+  - The library automatically enables INPUT_PULLUP
+
+  Created by breadbaker, 2025
+  This example code is in the public domain.
+*/
+
+#include <AsyncButton.h>
+
+// Define button pins - modify these for your hardware
+#define BUTTON_UP_PIN 2
+#define BUTTON_DOWN_PIN 3
+#define BUTTON_SELECT_PIN 4
+
+// Debounce 20ms, double click 300ms, long press 800ms
+AsyncButton::Panel<20, 300, 800, BUTTON_UP_PIN, BUTTON_DOWN_PIN, BUTTON_SELECT_PIN> panel;
+
+int value = 0;
+
+void setup()
+{
+    Serial.begin(115200);
+    while (!Serial)
+    {
+        ; // Wait for serial port to connect (needed for native USB)
+    }
+
+    Serial.println("AsyncButton Panel Example");
+    Serial.println("=========================");
+
+    // Initialize the panel, this also makes it the active configuration
+    panel.setup();
+
+    Serial.println("UP/DOWN change the value, SELECT prints it, long SELECT resets it");
+    Serial.println();
+}
+
+void loop()
+{
+    // Must call update() regularly for non-blocking operation
+    panel.update();
+
+    if (AsyncButton::isShortPressed(BUTTON_UP_PIN))
+    {
+        value++;
+        Serial.print("Value: ");
+        Serial.println(value);
+    }
+
+    if (AsyncButton::isShortPressed(BUTTON_DOWN_PIN))
+    {
+        value--;
+        Serial.print("Value: ");
+        Serial.println(value);
+    }
+
+    if (AsyncButton::isShortPressed(BUTTON_SELECT_PIN))
+    {
+        Serial.print("Selected value: ");
+        Serial.println(value);
+    }
+
+    if (AsyncButton::isLongPressed(BUTTON_SELECT_PIN))
+    {
+        value = 0;
+        Serial.println("Value reset");
+    }
+}
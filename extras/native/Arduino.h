@@ -0,0 +1,77 @@
+/* Arduino.h - Host-side stand-in for the Arduino core, used by the native AsyncButton builds
+Copyright (c) 2025 by breadbaker
+MIT License */
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#define LOW 0
+#define HIGH 1
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define CHANGE 1
+#define FALLING 2
+#define RISING 3
+#define NUM_DIGITAL_PINS 255 // Pins 0-254, pin 255 disables a button
+#define NATIVE_PINS 256
+#define NOT_AN_INTERRUPT -1
+#define F(x) x
+
+// Every pin has an interrupt and sits on one of 32 emulated ports of 8 pins
+#define digitalPinToInterrupt(p) ((int)(p))
+#define digitalPinToPort(p) ((p) / 8 + 1)
+#define digitalPinToBitMask(p) (1u << ((p) % 8))
+#define portInputRegister(port) (&Native::ports[(port)])
+
+namespace Native
+{
+    extern uint8_t pins[NATIVE_PINS];           // Level of each input pin
+    extern uint8_t modes[NATIVE_PINS];          // Mode set by pinMode()
+    extern uint16_t analog[NATIVE_PINS];        // Reading returned by analogRead()
+    extern uint32_t ports[NATIVE_PINS / 8 + 1]; // Port registers mirroring pins, port 0 is unused
+    extern void (*isr[NATIVE_PINS])();          // Handlers set by attachInterrupt()
+    extern unsigned long now;                   // Microseconds since start
+    extern unsigned long readCost;              // Microseconds each digitalRead() moves the clock (0 = free)
+
+    void reset();                           // Release all pins, detach handlers and restart the clock
+    void write(uint8_t pin, uint8_t level); // Drive an input pin, running its interrupt handler on a change
+    void advance(unsigned long us);         // Move the clock forward
+} // namespace Native
+
+inline int digitalRead(uint8_t pin)
+{
+    Native::now += Native::readCost;
+    return Native::pins[pin];
+}
+inline int analogRead(uint8_t pin) { return Native::analog[pin]; }
+inline void digitalWrite(uint8_t, uint8_t) {}
+inline void pinMode(uint8_t pin, uint8_t mode) { Native::modes[pin] = mode; }
+inline unsigned long millis() { return Native::now / 1000; }
+inline unsigned long micros() { return Native::now; }
+inline void delayMicroseconds(unsigned int us) { Native::advance(us); }
+inline void noInterrupts() {}
+inline void interrupts() {}
+inline void attachInterrupt(int irq, void (*handler)(), int) { Native::isr[irq] = handler; }
+inline void detachInterrupt(int irq) { Native::isr[irq] = nullptr; }
+
+struct NativeSerial
+{
+    void begin(unsigned long) {}
+    template <class T> void print(T value) { out(value); }
+    template <class T> void println(T value) { out(value), out("\n"); }
+    void println() { out("\n"); }
+    explicit operator bool() const { return true; }
+
+private:
+    void out(const char *text) { fputs(text, stdout); }
+    void out(char c) { fputc(c, stdout); }
+    void out(unsigned long value) { printf("%lu", value); }
+    void out(long value) { printf("%ld", value); }
+    void out(unsigned int value) { printf("%u", value); }
+    void out(int value) { printf("%d", value); }
+    void out(unsigned char value) { printf("%u", value); }
+};
+extern NativeSerial Serial;
@@ -0,0 +1,170 @@
+/* Fixture.cpp - Shared pieces of the native AsyncButton simulator: clock, scripted waveforms and silent button groups
+Copyright (c) 2025 by breadbaker
+MIT License */
+#include "Fixture.h"
+
+AsyncButton::State buttons[2] = {
+    BUTTON_STATE(SIM_PIN, 255),
+    BUTTON_STATE(3, 255),
+};
+AsyncButton::Config config = BUTTON_CONFIG(buttons, 2);
+unsigned long noise = 12345;
+#ifdef BUTTON_STATS
+static AsyncButton::Stats stats[2];
+#endif
+#ifdef BUTTON_ENCODERS
+static AsyncButton::Encoder encoders[] = {BUTTON_ENCODER(SIM_ENCODER_A, SIM_ENCODER_B, 4)};
+#endif
+
+#ifdef BUTTON_REPEAT
+static unsigned repeated = 0;
+static void onRepeat(uint8_t, uint16_t count)
+{
+    repeated = count;
+}
+#endif
+
+#ifdef BUTTON_GESTURES
+static unsigned recognized = 0;
+static void onGesture(uint8_t, uint8_t gesture)
+{
+    recognized |= 1u << gesture;
+}
+#endif
+
+void prepare()
+{
+    Native::reset();
+#ifdef BUTTON_STATS
+    config.stats = stats;
+#endif
+#ifdef BUTTON_REPEAT
+    AsyncButton::addRepeat(config, SIM_PIN, 300, 100, 20, 25, onRepeat);
+#endif
+#ifdef BUTTON_ENCODERS
+    AsyncButton::attach(config, encoders, 1);
+#endif
+#ifdef BUTTON_GESTURES
+    // Double, long and triple press; the double waits for the pause since a third press could follow
+    const char *patterns[] = {"..", "-", "..."};
+    for (const char *pattern : patterns)
+        AsyncButton::addGesture(config, SIM_PIN, pattern, onGesture);
+#endif
+    AsyncButton::setup(config, nullptr, BUT_SILENT);
+    AsyncButton::update();
+}
+
+bool chatter()
+{
+    noise = noise * 1103515245UL + 12345UL;
+    return (noise >> 16) & 1;
+}
+
+void step(unsigned long us)
+{
+    Native::advance(us);
+#ifdef BUTTON_TIMER
+    static unsigned long pending = 0;
+    for (pending += us; pending >= BUTTON_TIMER_PERIOD * 1000UL; pending -= BUTTON_TIMER_PERIOD * 1000UL)
+        AsyncButton::tick(); // Stands in for the timer interrupt
+#endif
+}
+
+// Update every millisecond, or lazily only on pin changes and when nextDeadline() comes due
+void simulate(const Segment *script, size_t length, Result &result, bool lazy)
+{
+    memset(&result, 0, sizeof(result));
+    result.idle = true;
+#ifdef BUTTON_REPEAT
+    repeated = 0;
+#endif
+#ifdef BUTTON_GESTURES
+    recognized = 0;
+#endif
+    const AsyncButton::State *button = &buttons[0];
+    uint8_t last = button->state, written = Native::pins[SIM_PIN];
+    unsigned long pressStart = 0, releaseStart = 0, t = 0;
+    for (size_t s = 0; s < length; ++s)
+    {
+        const Segment &segment = script[s];
+        if (segment.level == PRESSED)
+            pressStart = t;
+        else
+            releaseStart = t;
+        for (unsigned long ms = 0; ms < segment.ms; ++ms, ++t)
+        {
+            uint8_t level = segment.level;
+            if (ms < segment.bounce && chatter())
+                level = level == PRESSED ? RELEASED : PRESSED;
+            if (level != written && level == button->state)
+                result.bounces++;
+            Native::write(SIM_PIN, level);
+            step(SIM_PERIOD);
+            if (!lazy || level != written || AsyncButton::nextDeadline() == 0)
+            {
+                AsyncButton::update();
+                result.updates++;
+            }
+            written = level;
+            if (button->state != last)
+            {
+                last = button->state;
+                unsigned long latency = last == PRESSED ? t - pressStart : t - releaseStart;
+                unsigned long &worst = last == PRESSED ? result.pressLatency : result.releaseLatency;
+                if (latency > worst)
+                    worst = latency;
+                if (last == PRESSED)
+                    result.presses++;
+            }
+            if (last == PRESSED && AsyncButton::isIdle())
+                result.idle = false;
+            bool reported = true;
+            if (AsyncButton::isPressedDouble(SIM_PIN))
+                result.doubles++;
+            else if (AsyncButton::isLongPressed(SIM_PIN))
+                result.longs++;
+            else if (AsyncButton::isShortPressed(SIM_PIN))
+                result.shorts++;
+            else
+                reported = false;
+            if (reported && t - releaseStart > result.reportLatency)
+                result.reportLatency = t - releaseStart;
+#ifdef BUTTON_EVENT_QUEUE
+            AsyncButton::Event event;
+            while (AsyncButton::poll(event))
+                if (event.pin == SIM_PIN && event.type == BUTTON_EVENT_PRESS)
+                    result.events++;
+#endif
+        }
+    }
+    result.idle = result.idle && AsyncButton::isIdle();
+#ifdef BUTTON_REPEAT
+    result.repeats = repeated;
+#endif
+#ifdef BUTTON_GESTURES
+    result.gestures = recognized;
+#endif
+}
+
+void settle(AsyncButton::ButtonGroup &group, unsigned long ms)
+{
+    for (unsigned long t = 0; t < ms; ++t)
+    {
+        step(SIM_PERIOD);
+        group.update();
+    }
+}
+
+void tap(AsyncButton::ButtonGroup &group, uint8_t pin, unsigned long ms)
+{
+    Native::write(pin, PRESSED);
+    settle(group, ms);
+    Native::write(pin, RELEASED);
+    settle(group, BUTTON_DOUBLECLICK_TIME + 200);
+}
+
+bool check(const char *name, bool ok)
+{
+    printf("%s %s\n", name, ok ? "ok" : "FAIL");
+    return ok;
+}
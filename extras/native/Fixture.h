@@ -0,0 +1,113 @@
+/* Fixture.h - Shared pieces of the native AsyncButton simulator: clock, scripted waveforms and silent button groups
+Copyright (c) 2025 by breadbaker
+MIT License */
+#pragma once
+#include <AsyncButton.h>
+
+#define SIM_PIN 2
+#define SIM_PERIOD 1000 // update() period in microseconds
+
+struct Segment
+{
+    uint8_t level;        // Level the pin settles at (PRESSED/RELEASED)
+    unsigned long ms;     // Length of the segment in milliseconds
+    unsigned long bounce; // Chatter at the start of the segment in milliseconds
+};
+
+struct Result
+{
+    unsigned presses, shorts, longs, doubles, events;
+    bool idle;        // isIdle() held whenever the button was pressed and again at the end
+    unsigned updates; // update() calls made
+    unsigned repeats; // Auto-repeats of a held button
+    unsigned gestures; // Press patterns completed, one bit each
+    unsigned bounces;  // Readings that went back to the debounced level, the rule Stats counts by
+    unsigned long pressLatency, releaseLatency, reportLatency; // Worst case in milliseconds
+};
+
+#define SEGMENTS(script) (script), sizeof(script) / sizeof(Segment) // Script and its length for simulate()
+
+#ifdef BUTTON_ENCODERS
+#define SIM_ENCODER_A 20
+#define SIM_ENCODER_B 21
+#endif
+
+extern AsyncButton::State buttons[2]; // Buttons of the scripted configuration, SIM_PIN first
+extern AsyncButton::Config config;    // Scripted configuration, the active one until the panel check
+extern unsigned long noise;           // Deterministic chatter source
+
+void prepare();                                                                    // Reset the pins and set up the scripted configuration
+bool chatter();                                                                    // Next chatter bit, advancing noise
+void step(unsigned long us);                                                       // Move the clock, ticking the timer in between
+void simulate(const Segment *script, size_t length, Result &result, bool lazy);    // Play a script on SIM_PIN of the scripted configuration
+void settle(AsyncButton::ButtonGroup &group, unsigned long ms);                    // Update a group every millisecond
+void tap(AsyncButton::ButtonGroup &group, uint8_t pin, unsigned long ms);          // Press for ms, then wait out the double click window
+bool check(const char *name, bool ok);                                             // Print the result line of a check
+
+// Silent ButtonGroup owning its button states, one per feature check
+template <size_t N>
+class Fixture : public AsyncButton::ButtonGroup
+{
+public:
+    explicit Fixture(const AsyncButton::Timing *timing = nullptr) : ButtonGroup(buttons, N, timing), buttons() {}
+    explicit Fixture(const AsyncButton::State (&states)[N], const AsyncButton::Timing *timing = nullptr) : ButtonGroup(buttons, N, timing)
+    {
+        memcpy(buttons, states, sizeof(buttons));
+    }
+
+    bool setup() { return ButtonGroup::setup(nullptr, BUT_SILENT); }
+
+    AsyncButton::State buttons[N];
+};
+
+// Feature checks, each in its own file under checks/
+bool ladderChecks();
+bool expanderChecks();
+bool lookupChecks();
+bool matrixChecks();
+bool mappingChecks();
+bool budgetChecks();
+bool panelChecks();
+bool heapPanelChecks();
+#ifdef BUTTON_ENCODERS
+bool encoderChecks();
+#endif
+#ifdef BUTTON_IMMEDIATE
+bool immediateChecks();
+#endif
+#ifdef BUTTON_TIMING_PROFILES
+bool timingChecks();
+#endif
+#ifdef BUTTON_CHORDS
+bool chordChecks();
+#endif
+#ifdef BUTTON_HANDLERS
+bool handlerChecks();
+#endif
+#ifdef BUTTON_READERS
+bool readerChecks();
+#endif
+#ifdef BUTTON_STATS
+bool statsChecks(unsigned presses, unsigned longs, unsigned doubles, unsigned bounces);
+#endif
+#ifdef BUTTON_GESTURES
+bool gestureChecks();
+#endif
+#ifdef BUTTON_RECORD
+bool recordChecks();
+#endif
+#ifdef BUTTON_SNAPSHOT
+bool snapshotChecks();
+#endif
+#ifdef BUTTON_PROFILE
+bool profileChecks();
+#endif
+#ifdef BUTTON_TIMER
+bool timerChecks();
+#endif
+#if defined(BUTTON_INTERRUPT) || defined(BUTTON_TIMER)
+bool ownerChecks();
+#endif
+#ifdef ABUTTON_EDGES
+bool edgeChecks();
+#endif
@@ -0,0 +1,47 @@
+/* Native.cpp - Host-side stand-in for the Arduino core, used by the native AsyncButton builds
+Copyright (c) 2025 by breadbaker
+MIT License */
+#include <Arduino.h>
+
+NativeSerial Serial;
+
+namespace Native
+{
+    uint8_t pins[NATIVE_PINS];
+    uint8_t modes[NATIVE_PINS];
+    uint16_t analog[NATIVE_PINS];
+    uint32_t ports[NATIVE_PINS / 8 + 1];
+    void (*isr[NATIVE_PINS])();
+    unsigned long now;
+    unsigned long readCost;
+
+    void reset()
+    {
+        memset(pins, HIGH, sizeof(pins));
+        memset(ports, 0xFF, sizeof(ports));
+        memset(modes, INPUT, sizeof(modes));
+        for (uint16_t &reading : analog)
+            reading = 1023; // Pulled up to the reference
+        memset(isr, 0, sizeof(isr));
+        now = 100000000UL; // Start at 100 s, away from the zero timestamps
+        readCost = 0;
+    }
+
+    void write(uint8_t pin, uint8_t level)
+    {
+        if (pins[pin] == level)
+            return;
+        pins[pin] = level;
+        if (level)
+            ports[digitalPinToPort(pin)] |= digitalPinToBitMask(pin);
+        else
+            ports[digitalPinToPort(pin)] &= ~digitalPinToBitMask(pin);
+        if (isr[pin])
+            isr[pin]();
+    }
+
+    void advance(unsigned long us)
+    {
+        now += us;
+    }
+} // namespace Native
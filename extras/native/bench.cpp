@@ -0,0 +1,83 @@
+/* bench.cpp - Host-side timing of AsyncButton update() and press queries
+Copyright (c) 2025 by breadbaker
+MIT License */
+#include <AsyncButton.h>
+#include <chrono>
+#include <vector>
+
+static volatile bool sink; // Keeps the query results alive
+
+static double nanoseconds(std::chrono::steady_clock::time_point start, unsigned long count)
+{
+    std::chrono::duration<double, std::nano> spent = std::chrono::steady_clock::now() - start;
+    return spent.count() / count;
+}
+
+static void step()
+{
+    Native::advance(1000);
+#ifdef BUTTON_TIMER
+    static unsigned long pending = 0;
+    for (pending += 1000; pending >= BUTTON_TIMER_PERIOD * 1000UL; pending -= BUTTON_TIMER_PERIOD * 1000UL)
+        AsyncButton::tick(); // Stands in for the timer interrupt
+#endif
+}
+
+static uint8_t pinOf(size_t i)
+{
+    return i % 254; // Pins wrap around for the largest configuration, 255 disables a button
+}
+
+static void measure(size_t size)
+{
+    Native::reset();
+    std::vector<AsyncButton::State> buttons(size);
+    for (size_t i = 0; i < size; ++i)
+        buttons[i] = BUTTON_STATE(pinOf(i), 255);
+    static AsyncButton::Config config; // One object for every size, it keeps the interrupts and the timer
+    config = AsyncButton::Config();
+    config.buttons = buttons.data();
+    config.size = size;
+    AsyncButton::setup(config, nullptr, BUT_SILENT);
+    unsigned long rounds = 4000000UL / size > 2000 ? 4000000UL / size : 2000;
+
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned long r = 0; r < rounds; ++r)
+    {
+        step();
+        AsyncButton::update();
+    }
+    double idle = nanoseconds(start, rounds);
+
+    for (size_t i = 0; i < size; i += 8)
+        Native::write(pinOf(i), PRESSED); // Every eighth button held
+    start = std::chrono::steady_clock::now();
+    for (unsigned long r = 0; r < rounds; ++r)
+    {
+        step();
+        AsyncButton::update();
+    }
+    double held = nanoseconds(start, rounds);
+
+    unsigned long queries = rounds * 4;
+    start = std::chrono::steady_clock::now();
+    for (unsigned long q = 0; q < queries; ++q)
+        sink = AsyncButton::isShortPressed(pinOf(q % size), false);
+    double query = nanoseconds(start, queries);
+
+    printf("%7u %12.1f %12.1f %12.2f %10.1f\n", (unsigned)size, idle, held, held / size, query);
+#ifdef BUTTON_NO_DEFAULT_CONFIG
+    AsyncButton::Current = nullptr;
+#else
+    AsyncButton::Current = &AsyncButton::ButtonConfig;
+#endif
+}
+
+int main()
+{
+    printf("%7s %12s %12s %12s %10s\n", "buttons", "idle ns", "held ns", "ns/button", "query ns");
+    const size_t sizes[] = {3, 16, 64, 256};
+    for (size_t size : sizes)
+        measure(size);
+    return 0;
+}
@@ -0,0 +1,33 @@
+/* budget.cpp - Time-budgeted update(budget) rounds
+Copyright (c) 2025 by breadbaker
+MIT License */
+#include "../Fixture.h"
+
+// A full round over the buttons with update(0), one button per call
+static Fixture<4> budget({BUTTON_STATE(73, 255), BUTTON_STATE(74, 255), BUTTON_STATE(75, 255), BUTTON_STATE(76, 255)});
+
+bool budgetChecks()
+{
+    budget.setup();
+    for (uint8_t pin = 73; pin <= 76; ++pin)
+        Native::write(pin, PRESSED);
+    bool paced = true;
+    for (unsigned long t = 0; t < 100; ++t)
+    {
+        step(SIM_PERIOD);
+        for (int call = 0; call < 4; ++call)
+        {
+            budget.update(0);
+#ifndef BUTTON_VERTICAL_DEBOUNCE
+            paced = paced && (call == 3 || budget.nextDeadline() == 0); // The rest of the round is due at once, lanes take no budget
+#endif
+        }
+    }
+    bool ok = paced;
+    for (const AsyncButton::State &button : budget.buttons)
+        ok = ok && button.state == PRESSED;
+    for (uint8_t pin = 73; pin <= 76; ++pin)
+        Native::write(pin, RELEASED);
+    settle(budget, BUTTON_DOUBLECLICK_TIME + 200);
+    return check("update(budget): every button in one round per size calls", ok && budget.isShortPressed(76));
+}
@@ -0,0 +1,28 @@
+/* chords.cpp - Chords of buttons held together
+Copyright (c) 2025 by breadbaker
+MIT License */
+#include "../Fixture.h"
+
+#ifdef BUTTON_CHORDS
+// Two buttons held together fire the chord and swallow their own presses
+static const uint8_t chordPins[] = {84, 85};
+static Fixture<2> chords({BUTTON_STATE(84, 255), BUTTON_STATE(85, 255)});
+
+bool chordChecks()
+{
+    uint8_t chord = chords.addChord(chordPins, 2, 200, BUT_SWALLOW);
+    chords.setup();
+    Native::write(84, PRESSED);
+    settle(chords, 50);
+    Native::write(85, PRESSED);
+    settle(chords, 150);
+    bool early = chords.isChord(chord);
+    settle(chords, 150);
+    bool fired = chords.isChord(chord);
+    Native::write(84, RELEASED);
+    Native::write(85, RELEASED);
+    settle(chords, BUTTON_DOUBLECLICK_TIME + 200);
+    return check("chord: fires after the hold and swallows its buttons", chord == 0 && !early && fired && !chords.isChord(chord) &&
+                                                                        !chords.isPressed(84) && !chords.isPressed(85));
+}
+#endif
@@ -0,0 +1,46 @@
+/* edges.cpp - Edges queued by the interrupts or tick() and replayed by update() with their own times
+Copyright (c) 2025 by breadbaker
+MIT License */
+#include "../Fixture.h"
+
+#ifdef ABUTTON_EDGES
+// Hold the scripted button at a level for ms while update() stalls
+static void stall(uint8_t level, unsigned long ms)
+{
+    Native::write(SIM_PIN, level);
+    for (unsigned long t = 0; t < ms; ++t)
+        step(SIM_PERIOD);
+}
+
+bool edgeChecks()
+{
+    AsyncButton::Event event;
+    AsyncButton::update();
+    while (AsyncButton::poll(event))
+        ;
+    // A double press made entirely between two update() calls
+    stall(PRESSED, 100);
+    stall(RELEASED, 100);
+    stall(PRESSED, 100);
+    stall(RELEASED, 150);
+    AsyncButton::update();
+    const uint8_t expected[] = {BUTTON_EVENT_PRESS, BUTTON_EVENT_RELEASE, BUTTON_EVENT_PRESS, BUTTON_EVENT_RELEASE, BUTTON_EVENT_DOUBLE};
+    AsyncButton::Time times[5] = {};
+    size_t seen = 0;
+    while (AsyncButton::poll(event))
+        if (event.pin == SIM_PIN && seen < 5 && event.type == expected[seen])
+            times[seen++] = event.time;
+    bool ok = seen == 5;
+    // Each edge keeps the time it was accepted at, not the time of the update() that replayed it
+    ok = ok && times[1] - times[0] + 10 >= 100 && times[1] - times[0] <= 110;
+    ok = ok && times[2] - times[0] + 10 >= 200 && times[2] - times[0] <= 210;
+    printf("edges: stalled double press at +0, +%lu, +%lums\n", (unsigned long)(times[1] - times[0]), (unsigned long)(times[2] - times[0]));
+    for (unsigned long t = 0; t < BUTTON_DOUBLECLICK_TIME + 200; ++t)
+    {
+        step(SIM_PERIOD);
+        AsyncButton::update();
+    }
+    ok = ok && AsyncButton::isPressedDouble(SIM_PIN);
+    return check("edges: stalled presses replayed in order", ok);
+}
+#endif
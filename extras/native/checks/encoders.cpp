@@ -0,0 +1,55 @@
+/* encoders.cpp - Rotary encoder decoding alongside the scripted buttons
+Copyright (c) 2025 by breadbaker
+MIT License */
+#include "../Fixture.h"
+
+#ifdef BUTTON_ENCODERS
+// Turn the encoder by detents (negative = counter-clockwise), bouncing the contact that changes at every step
+static bool rotate(int detents)
+{
+    static const uint8_t clockwise[4] = {1, 0, 2, 3}, counter[4] = {2, 0, 1, 3}; // A/B phases after rest
+    unsigned turns = 0;
+    for (int d = 0; d < (detents < 0 ? -detents : detents); ++d)
+        for (uint8_t s = 0; s < 4; ++s)
+        {
+            uint8_t phase = detents > 0 ? clockwise[s] : counter[s];
+            uint8_t a = phase & 2 ? HIGH : LOW, b = phase & 1 ? HIGH : LOW;
+            uint8_t pin = a != Native::pins[SIM_ENCODER_A] ? SIM_ENCODER_A : SIM_ENCODER_B;
+            uint8_t level = pin == SIM_ENCODER_A ? a : b;
+            for (int bounce = 0; bounce < 3; ++bounce)
+            {
+                Native::write(pin, level);
+                Native::write(pin, !level);
+            }
+            Native::write(pin, level);
+            step(SIM_PERIOD);
+            AsyncButton::update();
+#ifdef BUTTON_EVENT_QUEUE
+            AsyncButton::Event event;
+            while (AsyncButton::poll(event))
+                if (event.type == (detents > 0 ? BUTTON_EVENT_TURN_CW : BUTTON_EVENT_TURN_CCW))
+                    turns++;
+#endif
+        }
+    int16_t turned = AsyncButton::readEncoder(0);
+    printf("encoder %+3d: %+3d detents", detents, turned);
+#ifdef BUTTON_EVENT_QUEUE
+    printf(", %u events", turns);
+    if (turns != (unsigned)(detents < 0 ? -detents : detents))
+        turned = ~detents;
+#else
+    (void)turns;
+#endif
+    printf(" %s\n", turned == detents ? "ok" : "FAIL");
+    return turned == detents;
+}
+
+bool encoderChecks()
+{
+    const int turns[] = {5, -3, 2, -1};
+    bool ok = true;
+    for (int detents : turns)
+        ok = rotate(detents) && ok;
+    return ok;
+}
+#endif
@@ -0,0 +1,53 @@
+/* expander.cpp - Rate limited bank transfers of AsyncButtonExpander.h
+Copyright (c) 2025 by breadbaker
+MIT License */
+#include "../Fixture.h"
+#include <AsyncButtonExpander.h>
+
+#define SIM_BANK_INTERVAL 5000 // Microseconds between transfers, five update() calls
+
+// Bank on a scripted bus, failing its transfers while the bus is down
+class ScriptedBank : public AsyncButton::Bank<1>
+{
+public:
+    ScriptedBank() : Bank<1>(220, SIM_BANK_INTERVAL), inputs(0xFF), down(true), attempts(0) {}
+
+    void scan() override
+    {
+        if (!due())
+            return;
+        attempts++;
+        if (down)
+        {
+            fail();
+            return;
+        }
+        frame[0] = inputs;
+        publish();
+    }
+
+    uint8_t inputs; // Levels of the eight inputs, active low
+    bool down;      // Transfers fail
+    unsigned attempts;
+};
+
+static ScriptedBank bank;
+static Fixture<1> banked({BUTTON_STATE(221, 255)});
+
+bool expanderChecks()
+{
+    banked.attach(bank);
+    banked.setup();
+    banked.update();
+    bool ok = bank.attempts == 1; // Due at once
+    settle(banked, 100);
+    // Failed transfers wait out the interval like complete ones
+    ok = ok && bank.failures() == bank.attempts && bank.attempts <= 100 * SIM_PERIOD / SIM_BANK_INTERVAL + 1;
+    bank.down = false;
+    bank.inputs = 0xFD; // Input 1 held
+    settle(banked, 200);
+    bank.inputs = 0xFF;
+    settle(banked, BUTTON_DOUBLECLICK_TIME + 200);
+    ok = ok && bank.transfers() && bank.transfers() + bank.failures() == bank.attempts;
+    return check("expander: transfers rate limited, failures included", ok && banked.isShortPressed(221));
+}
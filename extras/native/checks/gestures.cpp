@@ -0,0 +1,17 @@
+/* gestures.cpp - Press patterns of the scripted button
+Copyright (c) 2025 by breadbaker
+MIT License */
+#include "../Fixture.h"
+
+#ifdef BUTTON_GESTURES
+// No pattern extends the triple press, it completes at the third release
+bool gestureChecks()
+{
+    static const Segment triple[] = {{RELEASED, 100, 0}, {PRESSED, 100, 5}, {RELEASED, 150, 5}, {PRESSED, 100, 5},
+                                     {RELEASED, 150, 5}, {PRESSED, 100, 5}, {RELEASED, 800, 5}};
+    Result tripled;
+    simulate(SEGMENTS(triple), tripled, false);
+    printf("gesture triple: patterns %#x %s\n", tripled.gestures, tripled.gestures == 4 ? "ok" : "FAIL");
+    return tripled.gestures == 4;
+}
+#endif
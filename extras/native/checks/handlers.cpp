@@ -0,0 +1,28 @@
+/* handlers.cpp - Per-pin event callbacks
+Copyright (c) 2025 by breadbaker
+MIT License */
+#include "../Fixture.h"
+
+#ifdef BUTTON_HANDLERS
+// A short press handler sees one event with its context
+static Fixture<2> handlers({BUTTON_STATE(86, 255), BUTTON_STATE(87, 255)});
+
+static void onShort(const AsyncButton::Event &event, void *context)
+{
+    if (event.type == BUTTON_EVENT_SHORT)
+        ++*static_cast<unsigned *>(context);
+}
+
+bool handlerChecks()
+{
+    unsigned shorts = 0;
+    bool added = handlers.on(86, BUTTON_EVENT_BIT(BUTTON_EVENT_SHORT), onShort, &shorts);
+    handlers.setup();
+    tap(handlers, 86, 150);
+    tap(handlers, 87, 150);
+    unsigned first = shorts;
+    handlers.off(86, onShort);
+    tap(handlers, 86, 150);
+    return check("handlers: one call per short press, none after off()", added && first == 1 && shorts == 1);
+}
+#endif
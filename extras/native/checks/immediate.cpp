@@ -0,0 +1,51 @@
+/* immediate.cpp - Presses reported at the debounced press edge with BUT_IMMEDIATE
+Copyright (c) 2025 by breadbaker
+MIT License */
+#include "../Fixture.h"
+
+#ifdef BUTTON_IMMEDIATE
+// Reported at the press edge while still held, and only once
+static const AsyncButton::Timing trigger = {BUTTON_DEBOUNCE_TIME, 0, BUTTON_LONGPRESS_TIME, BUT_IMMEDIATE};
+static Fixture<1> immediate({BUTTON_STATE(77, 255)}, &trigger);
+
+// With a double click window, the short, long and double press of one button are each reported on their own
+static const AsyncButton::Timing kinds = {BUTTON_DEBOUNCE_TIME, BUTTON_DOUBLECLICK_TIME, BUTTON_LONGPRESS_TIME, BUT_IMMEDIATE};
+static Fixture<1> separate({BUTTON_STATE(78, 255)}, &kinds);
+
+static bool separateKinds()
+{
+    separate.setup();
+    Native::write(78, PRESSED);
+    settle(separate, BUTTON_DEBOUNCE_TIME + 10);
+    bool ok = separate.isPressed(78) && !separate.isPressed(78) && !separate.isLongPressed(78);
+    settle(separate, BUTTON_LONGPRESS_TIME);
+    ok = ok && separate.isLongPressed(78) && !separate.isLongPressed(78); // While still held, isPressed() took only the short one
+    Native::write(78, RELEASED);
+    settle(separate, BUTTON_DOUBLECLICK_TIME + 200);
+    ok = ok && !separate.isPressed(78) && !separate.isLongPressed(78);
+    Native::write(78, PRESSED);
+    settle(separate, 100);
+    Native::write(78, RELEASED);
+    settle(separate, 100);
+    ok = ok && separate.isShortPressed(78) && !separate.isPressedDouble(78);
+    Native::write(78, PRESSED);
+    settle(separate, BUTTON_DEBOUNCE_TIME + 10);
+    ok = ok && separate.isPressedDouble(78) && !separate.isPressedDouble(78) && separate.isShortPressed(78);
+    Native::write(78, RELEASED);
+    settle(separate, BUTTON_DOUBLECLICK_TIME + 200);
+    return check("immediate: short, long and double reported apart", ok && !separate.isPressed(78));
+}
+
+bool immediateChecks()
+{
+    immediate.setup();
+    Native::write(77, PRESSED);
+    settle(immediate, BUTTON_DEBOUNCE_TIME + 10);
+    bool ok = immediate.isShortPressed(77);
+    settle(immediate, 100);
+    Native::write(77, RELEASED);
+    settle(immediate, BUTTON_DOUBLECLICK_TIME + 200);
+    ok = check("immediate: reported while held", ok && !immediate.isPressed(77));
+    return separateKinds() && ok;
+}
+#endif
@@ -0,0 +1,39 @@
+/* ladder.cpp - Resistor ladder keys read through AsyncButtonAnalog.h
+Copyright (c) 2025 by breadbaker
+MIT License */
+#include "../Fixture.h"
+#include <AsyncButtonAnalog.h>
+
+#define SIM_LADDER 40
+static const uint16_t levels[] = {0, 512, 700};
+static AsyncButton::Ladder<3> ladder(SIM_LADDER, levels, 200);
+static Fixture<3> keypad({BUTTON_STATE(200, 255), BUTTON_STATE(201, 255), BUTTON_STATE(202, 255)});
+
+// Hold one ladder key with a noisy reading, sliding through the window of key 2 on the way down and up
+static bool press(uint8_t key, unsigned long ms)
+{
+    for (unsigned long t = 0; t < ms + 400; ++t)
+    {
+        bool held = t >= 100 && t < 100 + ms;
+        bool sliding = t == 100 || t == 100 + ms;
+        uint16_t level = held ? levels[key] : 1023;
+        Native::analog[SIM_LADDER] = sliding ? levels[2] : (uint16_t)(level - (level ? noise % 20 : 0));
+        chatter();
+        step(SIM_PERIOD);
+        keypad.update();
+    }
+    bool ok = ladder.first == 0;
+    for (uint8_t k = 0; k < 3; ++k)
+        ok = ok && keypad.isShortPressed(200 + k) == (k == key && ms < BUTTON_LONGPRESS_TIME) &&
+             keypad.isLongPressed(200 + k) == (k == key && ms >= BUTTON_LONGPRESS_TIME);
+    printf("ladder key %u %4lums %s\n", key, ms, ok ? "ok" : "FAIL");
+    return ok;
+}
+
+bool ladderChecks()
+{
+    keypad.attach(ladder);
+    keypad.setup();
+    bool ok = press(1, 200);
+    return press(0, BUTTON_LONGPRESS_TIME + 200) && ok;
+}
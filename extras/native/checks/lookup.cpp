@@ -0,0 +1,30 @@
+/* lookup.cpp - Buttons found through the pin table and the source offset instead of a scan
+Copyright (c) 2025 by breadbaker
+MIT License */
+#include "../Fixture.h"
+
+// Virtual pins past any table, listed in key order after two physical pins
+static AsyncButton::Actions actions(230, 4);
+static Fixture<6> lookup({BUTTON_STATE(60, 255), BUTTON_STATE(9, 255), BUTTON_STATE(230, 255), BUTTON_STATE(231, 255), BUTTON_STATE(232, 255), BUTTON_STATE(233, 255)});
+
+bool lookupChecks()
+{
+    lookup.attach(actions);
+    lookup.setup();
+    bool ok = actions.first == 2;
+    // The first entry takes the pin behind the back of setup(), a scan would stop there
+    lookup.buttons[0].pin = 232;
+    ok = ok && lookup.getState(232) == &lookup.buttons[4];
+#if BUTTON_PIN_TABLE_SIZE > 9
+    lookup.buttons[0].pin = 9;
+    ok = ok && lookup.getState(9) == &lookup.buttons[1];
+#endif
+    lookup.buttons[0].pin = 60;
+    // Physical pins beyond the table and virtual pins out of key order are still found by the scan
+    ok = ok && lookup.getState(60) == &lookup.buttons[0] && lookup.getState(9) == &lookup.buttons[1] && !lookup.getState(234);
+    lookup.buttons[2].pin = 231;
+    lookup.buttons[3].pin = 230;
+    lookup.setup();
+    ok = ok && actions.first == 255 && lookup.getState(230) == &lookup.buttons[3] && lookup.getState(231) == &lookup.buttons[2];
+    return check("lookup: pin table and source offset, scan for the rest", ok);
+}
@@ -0,0 +1,113 @@
+/* mapping.cpp - Buttons pressing other buttons through mappedPin and addMapping()
+Copyright (c) 2025 by breadbaker
+MIT License */
+#include "../Fixture.h"
+
+#define SIM_FAN 12 // Buttons mapped to one target through their mappedPin
+static Fixture<SIM_FAN + 1> fanned;
+
+// Press each of the buttons mapped to one target in turn, every one of them has to press it
+static bool fanIn()
+{
+    for (uint8_t i = 0; i < SIM_FAN; ++i)
+        fanned.buttons[i] = BUTTON_STATE(50 + i, 50 + SIM_FAN);
+    fanned.buttons[SIM_FAN] = BUTTON_STATE(50 + SIM_FAN, 255);
+    fanned.setup();
+    unsigned reached = 0;
+    for (uint8_t i = 0; i < SIM_FAN; ++i)
+    {
+        Native::write(50 + i, PRESSED);
+        settle(fanned, 100);
+        if (fanned.buttons[SIM_FAN].state == PRESSED)
+            reached++;
+        Native::write(50 + i, RELEASED);
+        settle(fanned, 600);
+    }
+    bool ok = reached == SIM_FAN && fanned.buttons[SIM_FAN].state == RELEASED;
+    printf("fan-in: %u of %u mapped buttons press the target %s\n", reached, SIM_FAN, ok ? "ok" : "FAIL");
+    return ok;
+}
+
+#ifndef BUTTON_COMPACT_STATE
+// Positional initializers of the 1.x State still compile, 60 maps to 61 through its mappedPin;
+// they leave the fields derived by setup() to value-initialization, which -Wextra points out
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmissing-field-initializers"
+static Fixture<2> legacy({
+    {60, RELEASED, false, 0, 0, RELEASED, 0, 0, 61, nullptr},
+    {61, RELEASED, false, 0, 0, RELEASED, 0, 0, 255, nullptr},
+});
+#pragma GCC diagnostic pop
+
+static bool positional()
+{
+    legacy.setup();
+    bool ok = legacy.buttons[0].mappedState == &legacy.buttons[1] && !legacy.buttons[1].mappedState;
+    tap(legacy, 60, 150);
+    return check("mapping: positional 1.x initializer", ok && legacy.isShortPressed(60) && legacy.isShortPressed(61));
+}
+#endif
+
+#if BUTTON_MAX_MAPPINGS > 0
+// 70 maps to 72 through mappedPin, 71 through addMapping(), 72 stays pressed until its last mapper lets go
+static Fixture<3> mapping({BUTTON_STATE(70, 72), BUTTON_STATE(71, 255), BUTTON_STATE(72, 255)});
+
+static bool mappings()
+{
+    AsyncButton::State *mapped = mapping.buttons;
+    mapping.addMapping(71, 72);
+    mapping.setup();
+    tap(mapping, 71, 150);
+    bool ok = mapping.isShortPressed(71) && mapping.isShortPressed(72);
+    Native::write(70, PRESSED);
+    Native::write(71, PRESSED);
+    settle(mapping, 150);
+    Native::write(70, RELEASED);
+    settle(mapping, 150);
+    ok = ok && mapped[2].state == PRESSED;
+    Native::write(71, RELEASED);
+    settle(mapping, 150);
+    ok = ok && mapped[2].state == RELEASED;
+    settle(mapping, BUTTON_DOUBLECLICK_TIME + 200);
+    return check("mapping: addMapping() and two mappers held", ok && mapping.isShortPressed(72) && !mapped[2].doublePress);
+}
+
+// 80 maps to 81 through mappedPin; 81 -> 80 would close a cycle and a second 80 -> 81 repeats it, 81 -> 82 is kept
+static Fixture<3> pruned({BUTTON_STATE(80, 81), BUTTON_STATE(81, 255), BUTTON_STATE(82, 255)});
+
+static bool pruning()
+{
+    pruned.addMapping(81, 80);
+    pruned.addMapping(80, 81);
+    pruned.addMapping(81, 82);
+    pruned.setup();
+    const AsyncButton::Config &conf = pruned.getConfig();
+    bool ok = conf.mappings[0].from == 255 && conf.mappings[1].from == 255 && conf.mappings[2].from == 1;
+    ok = ok && pruned.buttons[0].firstLink == 255 && pruned.buttons[1].firstLink == 2 && pruned.buttons[2].firstLinked == 2;
+    Native::write(80, PRESSED);
+    settle(pruned, 150);
+    ok = ok && pruned.buttons[1].state == PRESSED && pruned.buttons[2].state == PRESSED;
+    Native::write(80, RELEASED);
+    settle(pruned, 150);
+    ok = ok && pruned.buttons[0].state == RELEASED && pruned.buttons[2].state == RELEASED;
+    Native::write(81, PRESSED);
+    settle(pruned, 150);
+    ok = ok && pruned.buttons[0].state == RELEASED && pruned.buttons[2].state == PRESSED;
+    Native::write(81, RELEASED);
+    settle(pruned, BUTTON_DOUBLECLICK_TIME + 200);
+    return check("mapping: cycle and repeated edge dropped at setup", ok);
+}
+#endif
+
+bool mappingChecks()
+{
+    bool ok = fanIn();
+#ifndef BUTTON_COMPACT_STATE
+    ok = positional() && ok;
+#endif
+#if BUTTON_MAX_MAPPINGS > 0
+    ok = pruning() && ok;
+    ok = mappings() && ok;
+#endif
+    return ok;
+}
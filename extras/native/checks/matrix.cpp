@@ -0,0 +1,34 @@
+/* matrix.cpp - Key matrix scanned one row per update()
+Copyright (c) 2025 by breadbaker
+MIT License */
+#include "../Fixture.h"
+
+// Key (1, 0) of a 2x2 matrix on rows 80-81 and columns 82-83, wired by the simulator
+static const uint8_t matrixRows[] = {80, 81}, matrixCols[] = {82, 83};
+static AsyncButton::Matrix<2, 2> matrix(matrixRows, matrixCols, 210);
+static Fixture<4> keyboard({BUTTON_STATE(210, 255), BUTTON_STATE(211, 255), BUTTON_STATE(212, 255), BUTTON_STATE(213, 255)});
+
+static void scanMatrix(bool held, unsigned long ms)
+{
+    for (unsigned long t = 0; t < ms; ++t)
+    {
+        // The key connects column 0 to row 1 while that row is driven LOW
+        Native::write(matrixCols[0], held && Native::modes[matrixRows[1]] == OUTPUT ? LOW : HIGH);
+        step(SIM_PERIOD);
+        keyboard.update();
+    }
+}
+
+bool matrixChecks()
+{
+    keyboard.attach(matrix);
+    keyboard.setup();
+    scanMatrix(false, 100);
+    scanMatrix(true, 200);
+    bool ok = keyboard.buttons[2].state == PRESSED;
+    scanMatrix(false, BUTTON_DOUBLECLICK_TIME + 200);
+    ok = ok && keyboard.isShortPressed(212);
+    for (uint8_t key = 210; key <= 213; ++key)
+        ok = ok && !keyboard.isPressed(key);
+    return check("matrix: key (1, 0), keys indexed in order", ok && !matrix.ghosts() && matrix.first == 0 && keyboard.getState(213) == &keyboard.buttons[3]);
+}
@@ -0,0 +1,17 @@
+/* owner.cpp - A second configuration refused the pin change interrupts and the timer
+Copyright (c) 2025 by breadbaker
+MIT License */
+#include "../Fixture.h"
+
+#if defined(BUTTON_INTERRUPT) || defined(BUTTON_TIMER)
+// Set up after the scripted configuration, which keeps the interrupts and the timer
+static Fixture<1> second({BUTTON_STATE(89, 255)});
+
+bool ownerChecks()
+{
+    bool refused = !second.setup();
+    tap(second, 89, 150); // Scanned on every update() instead
+    bool owner = AsyncButton::setup(config, nullptr, BUT_SILENT);
+    return check("setup: second configuration refused, still scanned", refused && owner && second.isShortPressed(89));
+}
+#endif
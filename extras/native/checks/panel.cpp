@@ -0,0 +1,58 @@
+/* panel.cpp - Compile-time Panel front end
+Copyright (c) 2025 by breadbaker
+MIT License */
+#include "../Fixture.h"
+#include <new>
+
+// A panel on 89-90 becomes the active configuration, its update() has to keep nextDeadline() current on every variant
+static AsyncButton::DefaultPanel<89, 90> panel;
+
+bool panelChecks()
+{
+    panel.setup(nullptr, BUT_SILENT);
+    Native::write(89, PRESSED);
+    bool waits = false;
+    for (unsigned long t = 0; t < 150; ++t)
+    {
+        step(SIM_PERIOD);
+        panel.update();
+        if (t < BUTTON_DEBOUNCE_TIME)
+            waits = waits || AsyncButton::nextDeadline() != BUTTON_NO_DEADLINE; // Debouncing once the change was seen
+    }
+    Native::write(89, RELEASED);
+    for (unsigned long t = 0; t < BUTTON_DOUBLECLICK_TIME + 200; ++t)
+    {
+        step(SIM_PERIOD);
+        panel.update();
+    }
+    bool ok = waits && AsyncButton::nextDeadline() == BUTTON_NO_DEADLINE && AsyncButton::isShortPressed(89) && !AsyncButton::isPressed(90);
+    return check("panel: short press and deadlines", ok);
+}
+
+// A panel built over dirty memory, as on the stack or the heap, starts from a cleared configuration
+static unsigned char arena[sizeof(AsyncButton::DefaultPanel<91>)];
+
+bool heapPanelChecks()
+{
+    memset(arena, 0xA5, sizeof(arena));
+    auto *dirty = new (arena) AsyncButton::DefaultPanel<91>; // Default-initialized, like a local
+    dirty->setup(nullptr, BUT_SILENT);
+    Native::write(91, PRESSED);
+    for (unsigned long t = 0; t < 150; ++t)
+    {
+        step(SIM_PERIOD);
+        dirty->update();
+    }
+    Native::write(91, RELEASED);
+    for (unsigned long t = 0; t < BUTTON_DOUBLECLICK_TIME + 200; ++t)
+    {
+        step(SIM_PERIOD);
+        dirty->update();
+    }
+    const AsyncButton::Config &conf = dirty->getConfig();
+    bool cleared = !conf.sources;
+#if BUTTON_MAX_MAPPINGS > 0
+    cleared = cleared && !conf.mappingCount;
+#endif
+    return check("panel: cleared over dirty memory", cleared && AsyncButton::isShortPressed(91));
+}
@@ -0,0 +1,50 @@
+/* profile.cpp - On-target profiling counters
+Copyright (c) 2025 by breadbaker
+MIT License */
+#include "../Fixture.h"
+
+#ifdef BUTTON_PROFILE
+#define SIM_READ_COST 1000 // Mock time in microseconds each digitalRead() takes in the timed run
+
+// Two buttons read by digitalRead() on every update(), the events of the second one are handled
+static Fixture<2> timed({BUTTON_STATE(40, 255), BUTTON_STATE(41, 255)});
+
+#ifdef BUTTON_HANDLERS
+static void onEvent(const AsyncButton::Event &, void *) {}
+#endif
+
+bool profileChecks()
+{
+    AsyncButton::Profile profile;
+    AsyncButton::getProfile(profile);
+    bool ok = profile.update.count && profile.query.count;
+#ifdef BUTTON_HANDLERS
+    timed.on(41, 0xFFFF, onEvent);
+#endif
+    timed.setup();
+    timed.resetProfile();
+    Native::readCost = SIM_READ_COST;
+    tap(timed, 41, 150);
+    Native::readCost = 0;
+    ok = ok && timed.isShortPressed(41);
+    // The group keeps its own counters, those of the scripted configuration stay where they were
+    uint32_t updates = profile.update.count;
+    AsyncButton::getProfile(profile);
+    ok = ok && profile.update.count == updates;
+    timed.getProfile(profile);
+    printf("profile: %lu updates, %lu-%lu us (avg %lu), %lu queries, %lu events, latency %lums\n",
+           (unsigned long)profile.update.count, (unsigned long)profile.update.min, (unsigned long)profile.update.max,
+           (unsigned long)profile.update.average, (unsigned long)profile.query.count, (unsigned long)profile.events,
+           (unsigned long)profile.latency);
+    // Every update() reads both pins, so none is shorter than the two reads
+    const uint32_t reads = 2 * SIM_READ_COST;
+    ok = ok && profile.update.min >= reads && profile.update.max >= profile.update.min &&
+         profile.update.average >= profile.update.min && profile.update.average <= profile.update.max;
+    ok = ok && profile.query.count && profile.events >= 3;
+#ifdef BUTTON_HANDLERS
+    // The events of the second button are delivered after both reads of their update()
+    ok = ok && profile.latency == reads / 1000;
+#endif
+    return check("profile: timed update() and event latency", ok);
+}
+#endif
@@ -0,0 +1,22 @@
+/* readers.cpp - Per-consumer press Readers
+Copyright (c) 2025 by breadbaker
+MIT License */
+#include "../Fixture.h"
+
+#ifdef BUTTON_READERS
+// Two readers each see the press once, and the group query still sees it after them
+static Fixture<1> readers({BUTTON_STATE(88, 255)});
+
+bool readerChecks()
+{
+    readers.setup();
+    AsyncButton::Reader<1> ui(readers.getConfig()), logger(readers.getConfig());
+    tap(readers, 88, 150);
+    bool ok = ui.isShortPressed(88) && !ui.isShortPressed(88) && logger.isPressed(88) && !logger.isPressed(88) &&
+              readers.isShortPressed(88);
+    tap(readers, 88, 150);
+    AsyncButton::Reader<1> late(readers.getConfig());
+    late.sync();
+    return check("readers: each sees every press once", ok && !late.isPressed(88) && ui.isPressed(88));
+}
+#endif
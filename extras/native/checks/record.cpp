@@ -0,0 +1,24 @@
+/* record.cpp - Edge recording and replay of the scripted button
+Copyright (c) 2025 by breadbaker
+MIT License */
+#include "../Fixture.h"
+
+#ifdef BUTTON_RECORD
+// Record a double press, then play it back with the pin left released
+bool recordChecks()
+{
+    static AsyncButton::Mark marks[8];
+    static AsyncButton::Tape tape = BUTTON_TAPE(marks);
+    static const Segment doublePress[] = {{RELEASED, 100, 0}, {PRESSED, 120, 5}, {RELEASED, 120, 5}, {PRESSED, 120, 5}, {RELEASED, 800, 5}};
+    static const Segment quiet[] = {{RELEASED, 1500, 0}};
+    Result live, played;
+    AsyncButton::record(config, &tape);
+    simulate(SEGMENTS(doublePress), live, false);
+    bool replaying = AsyncButton::replay(config, &tape);
+    simulate(SEGMENTS(quiet), played, true);
+    bool replayed = replaying && tape.count == 4 && !AsyncButton::isReplaying() && played.presses == live.presses && played.doubles == 1;
+    printf("replay: %u marks, %u presses, %u double, %u updates %s\n", tape.count, played.presses, played.doubles, played.updates, replayed ? "ok" : "FAIL");
+    AsyncButton::record(config, nullptr);
+    return replayed;
+}
+#endif
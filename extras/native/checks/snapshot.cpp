@@ -0,0 +1,41 @@
+/* snapshot.cpp - Config snapshot and restore across a loss of RAM
+Copyright (c) 2025 by breadbaker
+MIT License */
+#include "../Fixture.h"
+
+#ifdef BUTTON_SNAPSHOT
+bool snapshotChecks()
+{
+    // Snapshot during a press, lose the RAM and 10 s of sleep, restore and finish the press
+    static uint8_t image[BUTTON_SNAPSHOT_SIZE(2)];
+    static const Segment held[] = {{PRESSED, 150, 0}};
+    static const Segment release[] = {{PRESSED, 150, 0}, {RELEASED, 800, 0}};
+    Result before, after;
+    simulate(SEGMENTS(held), before, false);
+    size_t saved = AsyncButton::snapshot(config, image, sizeof(image));
+    memset(buttons, 0, sizeof(buttons));
+    step(10000000UL);
+    image[sizeof(image) / 2] ^= 1;
+    bool corrupt = AsyncButton::restore(config, image, sizeof(image));
+    image[sizeof(image) / 2] ^= 1;
+    bool restored = AsyncButton::restore(config, image, sizeof(image)) && buttons[0].state == PRESSED;
+    simulate(SEGMENTS(release), after, false);
+    bool resumed = saved == sizeof(image) && !corrupt && restored && after.shorts == 1 && after.longs == 0 &&
+                   after.reportLatency + 300 >= BUTTON_DOUBLECLICK_TIME; // Still waits out the window from the press 300 ms before the release
+    printf("snapshot: %u bytes, restored %d, short %u long %u double %u, report %lums %s\n", (unsigned)saved, restored, after.shorts, after.longs, after.doubles,
+           after.reportLatency, resumed ? "ok" : "FAIL");
+    bool ok = resumed;
+    // Sleep between the two presses of a double press
+    static const Segment first[] = {{PRESSED, 120, 0}, {RELEASED, 100, 0}};
+    static const Segment second[] = {{RELEASED, 20, 0}, {PRESSED, 120, 0}, {RELEASED, 800, 0}};
+    simulate(SEGMENTS(first), before, false);
+    AsyncButton::snapshot(config, image, sizeof(image));
+    memset(buttons, 0, sizeof(buttons));
+    step(10000000UL);
+    restored = AsyncButton::restore(config, image, sizeof(image));
+    simulate(SEGMENTS(second), after, false);
+    resumed = restored && before.shorts == 0 && after.doubles == 1 && after.shorts == 0;
+    printf("snapshot double: restored %d, short %u double %u %s\n", restored, after.shorts, after.doubles, resumed ? "ok" : "FAIL");
+    return ok && resumed;
+}
+#endif
@@ -0,0 +1,27 @@
+/* stats.cpp - Per-button statistics of the scripted button
+Copyright (c) 2025 by breadbaker
+MIT License */
+#include "../Fixture.h"
+
+#ifdef BUTTON_STATS
+// The counters match the presses and bounces of the scenarios played so far, the same on every engine
+bool statsChecks(unsigned presses, unsigned longs, unsigned doubles, unsigned bounces)
+{
+    const AsyncButton::Stats *counted = AsyncButton::getStats(SIM_PIN);
+    unsigned binned = 0;
+    for (uint16_t bin : counted->durations)
+        binned += bin;
+    printf("stats: %u presses, %u long, %u double, %u of %u bounces\n", counted->presses, counted->longs, counted->doubles, counted->bounces, bounces);
+    bool ok = counted->presses == presses && counted->longs == longs && counted->doubles == doubles && binned == presses;
+    ok = ok && bounces && counted->bounces == bounces;
+    // Glitches longer than a vertical counter tick but shorter than the debounce time, one bounce each on every engine
+    static const Segment glitches[] = {{RELEASED, 100, 0}, {PRESSED, 2 * BUTTON_VERTICAL_TICK, 0}, {RELEASED, 100, 0},
+                                       {PRESSED, 2 * BUTTON_VERTICAL_TICK, 0}, {RELEASED, 100, 0}, {PRESSED, 2 * BUTTON_VERTICAL_TICK, 0}, {RELEASED, 800, 0}};
+    Result rejected;
+    AsyncButton::resetStats();
+    simulate(SEGMENTS(glitches), rejected, false);
+    bool counting = counted->bounces == 3 && !counted->presses && !rejected.presses;
+    printf("stats glitches: %u bounces, %u presses %s\n", counted->bounces, counted->presses, counting ? "ok" : "FAIL");
+    return ok && counting;
+}
+#endif
@@ -0,0 +1,38 @@
+/* timer.cpp - Edges latched by tick() with their own times while update() stalls
+Copyright (c) 2025 by breadbaker
+MIT License */
+#include "../Fixture.h"
+
+#ifdef BUTTON_TIMER
+// Leave the pins of both scripted buttons at a level for ms while only the timer runs
+static void stall(uint8_t level2, uint8_t level3, unsigned long ms)
+{
+    Native::write(SIM_PIN, level2);
+    Native::write(3, level3);
+    for (unsigned long t = 0; t < ms; ++t)
+        step(SIM_PERIOD);
+}
+
+bool timerChecks()
+{
+    // Both buttons of one lane pressed and released at different times, all between two update() calls
+    AsyncButton::update();
+    stall(PRESSED, RELEASED, 100);
+    stall(PRESSED, PRESSED, 200);
+    stall(RELEASED, PRESSED, 200);
+    stall(RELEASED, RELEASED, 100);
+    AsyncButton::update();
+    const AsyncButton::State *first = &buttons[0], *second = &buttons[1];
+    bool ok = first->state == RELEASED && second->state == RELEASED;
+    ok = ok && first->duration + BUTTON_VERTICAL_TICK >= 300 && first->duration <= 300 + BUTTON_VERTICAL_TICK;
+    ok = ok && second->duration + BUTTON_VERTICAL_TICK >= 400 && second->duration <= 400 + BUTTON_VERTICAL_TICK;
+    printf("timer: stalled presses of %lums and %lums\n", (unsigned long)first->duration, (unsigned long)second->duration);
+    for (unsigned long t = 0; t < BUTTON_DOUBLECLICK_TIME + 200; ++t)
+    {
+        step(SIM_PERIOD);
+        AsyncButton::update();
+    }
+    ok = ok && AsyncButton::isShortPressed(SIM_PIN) && AsyncButton::isShortPressed(3);
+    return check("timer: each button keeps its own edge times", ok);
+}
+#endif
@@ -0,0 +1,24 @@
+/* timing.cpp - Per-button timing profiles
+Copyright (c) 2025 by breadbaker
+MIT License */
+#include "../Fixture.h"
+
+#ifdef BUTTON_TIMING_PROFILES
+// The same 400 ms press is long for a 300 ms profile and short for the default timing
+static const AsyncButton::Timing quick = {10, 0, 300, 0};
+static Fixture<2> profiles({BUTTON_STATE_TIMING(78, 255, &quick), BUTTON_STATE(79, 255)});
+
+bool timingChecks()
+{
+    profiles.setup();
+    Native::write(78, PRESSED);
+    Native::write(79, PRESSED);
+    settle(profiles, 400);
+    Native::write(78, RELEASED);
+    Native::write(79, RELEASED);
+    settle(profiles, 20);
+    bool ok = profiles.isLongPressed(78) && !profiles.isPressed(79); // No double click window on the quick profile
+    settle(profiles, BUTTON_DOUBLECLICK_TIME + 200);
+    return check("timing profiles: long at 300 ms, short at the default", ok && profiles.isShortPressed(79));
+}
+#endif
@@ -0,0 +1,165 @@
+/* sim.cpp - Scripted bounce waveforms checking AsyncButton detection latency and correctness
+Copyright (c) 2025 by breadbaker
+MIT License */
+#include "Fixture.h"
+
+struct Scenario
+{
+    const char *name;
+    const Segment *script;
+    size_t length;
+    unsigned presses, shorts, longs, doubles; // Expected physical presses and reports
+};
+
+#define SCENARIO(name, script, presses, shorts, longs, doubles) {name, script, sizeof(script) / sizeof(Segment), presses, shorts, longs, doubles}
+
+static const Segment cleanShort[] = {{RELEASED, 100, 0}, {PRESSED, 200, 0}, {RELEASED, 800, 0}};
+static const Segment bouncyShort[] = {{RELEASED, 100, 0}, {PRESSED, 200, 8}, {RELEASED, 800, 8}};
+static const Segment longPress[] = {{RELEASED, 100, 0}, {PRESSED, BUTTON_LONGPRESS_TIME + 300, 5}, {RELEASED, 800, 5}};
+static const Segment doublePress[] = {{RELEASED, 100, 0}, {PRESSED, 120, 5}, {RELEASED, 120, 5}, {PRESSED, 120, 5}, {RELEASED, 800, 5}};
+static const Segment glitch[] = {{RELEASED, 100, 0}, {PRESSED, BUTTON_DEBOUNCE_TIME / 2, 0}, {RELEASED, 800, 0}};
+static const Segment chatterOnly[] = {{RELEASED, 100, 0}, {RELEASED, 800, BUTTON_DEBOUNCE_TIME / 2}};
+
+int main()
+{
+    prepare();
+
+    // Random press lengths and bounce, spaced beyond the double click window
+    static Segment series[100];
+    for (size_t i = 0; i < 100; i += 2)
+    {
+        series[i] = {PRESSED, 80 + (unsigned long)(noise % 200), (unsigned long)(noise % 10)};
+        chatter();
+        series[i + 1] = {RELEASED, BUTTON_DOUBLECLICK_TIME + 200, (unsigned long)(noise % 10)};
+        chatter();
+    }
+
+    const Scenario scenarios[] = {
+        SCENARIO("clean short", cleanShort, 1, 1, 0, 0),
+        SCENARIO("bouncy short", bouncyShort, 1, 1, 0, 0),
+        SCENARIO("long", longPress, 1, 0, 1, 0),
+        SCENARIO("double", doublePress, 2, 0, 0, 1),
+        SCENARIO("glitch", glitch, 0, 0, 0, 0),
+        SCENARIO("chatter", chatterOnly, 0, 0, 0, 0),
+        SCENARIO("random series", series, 50, 50, 0, 0),
+    };
+
+    // Debounce window plus one vertical counter round of slack
+    const unsigned long limit = BUTTON_DEBOUNCE_TIME + 2 * BUTTON_VERTICAL_TICK + 2;
+    int failures = 0;
+    unsigned presses = 0, longs = 0, doubles = 0, bounces = 0;
+#ifdef BUTTON_REPEAT
+    unsigned repeats[sizeof(scenarios) / sizeof(Scenario)]; // Of each scenario updated every millisecond
+#endif
+    printf("%-21s %8s %8s %8s %8s  %s\n", "scenario", "press", "release", "report", "updates", "result");
+    for (int lazy = 0; lazy < 2; ++lazy)
+    for (const Scenario &scenario : scenarios)
+    {
+        Result result;
+        simulate(scenario.script, scenario.length, result, lazy);
+        unsigned long bounce = 10;
+        bool ok = result.presses == scenario.presses &&
+                  result.shorts == scenario.shorts &&
+                  result.longs == scenario.longs &&
+                  result.doubles == scenario.doubles &&
+                  result.idle &&
+                  result.pressLatency <= limit + bounce &&
+                  result.releaseLatency <= limit + bounce;
+#ifdef BUTTON_EVENT_QUEUE
+        ok = ok && result.events == scenario.presses;
+#endif
+#ifdef BUTTON_REPEAT
+        // Repeats only of the long press, and on the same schedule when updated lazily
+        size_t n = &scenario - scenarios;
+        ok = ok && (result.repeats > 0) == (scenario.longs > 0) && (!lazy || result.repeats == repeats[n]);
+        repeats[n] = result.repeats;
+#endif
+#ifdef BUTTON_GESTURES
+        ok = ok && result.gestures == ((scenario.doubles ? 1u : 0u) | (scenario.longs ? 2u : 0u));
+#endif
+        presses += scenario.presses;
+        longs += scenario.longs;
+        doubles += scenario.doubles;
+        bounces += result.bounces;
+        printf("%-14s%-7s %6lums %6lums %6lums %8u  %s", scenario.name, lazy ? " (lazy)" : "", result.pressLatency, result.releaseLatency,
+               result.reportLatency, result.updates, ok ? "ok" : "FAIL");
+        if (!ok)
+        {
+            printf(" (presses %u/%u short %u/%u long %u/%u double %u/%u idle %d)", result.presses, scenario.presses,
+                   result.shorts, scenario.shorts, result.longs, scenario.longs, result.doubles, scenario.doubles, result.idle);
+            failures++;
+        }
+        printf("\n");
+    }
+#ifdef BUTTON_ENCODERS
+    if (!encoderChecks())
+        failures++;
+#endif
+    if (!ladderChecks())
+        failures++;
+    if (!expanderChecks())
+        failures++;
+    if (!lookupChecks())
+        failures++;
+    if (!mappingChecks())
+        failures++;
+    if (!budgetChecks())
+        failures++;
+    if (!matrixChecks())
+        failures++;
+#ifdef BUTTON_IMMEDIATE
+    if (!immediateChecks())
+        failures++;
+#endif
+#ifdef BUTTON_TIMING_PROFILES
+    if (!timingChecks())
+        failures++;
+#endif
+#ifdef BUTTON_CHORDS
+    if (!chordChecks())
+        failures++;
+#endif
+#ifdef BUTTON_HANDLERS
+    if (!handlerChecks())
+        failures++;
+#endif
+#ifdef BUTTON_READERS
+    if (!readerChecks())
+        failures++;
+#endif
+#ifdef BUTTON_STATS
+    if (!statsChecks(presses, longs, doubles, bounces))
+        failures++;
+#endif
+#ifdef BUTTON_GESTURES
+    if (!gestureChecks())
+        failures++; // After the statistics check, which leaves no press pending
+#endif
+#ifdef BUTTON_RECORD
+    if (!recordChecks())
+        failures++;
+#endif
+#ifdef BUTTON_SNAPSHOT
+    if (!snapshotChecks())
+        failures++;
+#endif
+#ifdef BUTTON_PROFILE
+    if (!profileChecks())
+        failures++;
+#endif
+#ifdef BUTTON_TIMER
+    if (!timerChecks())
+        failures++;
+#endif
+#ifdef ABUTTON_EDGES
+    if (!edgeChecks())
+        failures++;
+#endif
+#if defined(BUTTON_INTERRUPT) || defined(BUTTON_TIMER)
+    if (!ownerChecks())
+        failures++;
+#endif
+    if (!panelChecks() || !heapPanelChecks())
+        failures++; // Last, the panels take over the active configuration
+    return failures ? 1 : 0;
+}